@@ -0,0 +1,44 @@
+#ifndef AGGREGATE_STACK_H_INCLUDED
+#define AGGREGATE_STACK_H_INCLUDED
+
+#include "stack.h"
+
+typedef long long aggregate_t;
+typedef aggregate_t (*aggregate_combine)(aggregate_t left, aggregate_t right);
+
+enum aggregate_index {
+    AGGREGATE_MIN           = 0,
+    AGGREGATE_MAX           = 1,
+    AGGREGATE_SUM           = 2,
+
+    AGGREGATE_BUILTIN_COUNT
+};
+
+const ssize_t AGGREGATE_MAX_COUNT = 8;
+
+struct aggregate_stack {
+    stack                          *stk;
+
+    aggregate_combine               combines[AGGREGATE_MAX_COUNT];
+    aggregate_t                    *levels  [AGGREGATE_MAX_COUNT];
+    ssize_t                         aggregates_count;
+    ssize_t                         levels_capacity;
+};
+
+ssize_t aggregate_stack_constructor(aggregate_stack *astk);
+ssize_t aggregate_stack_destructor(aggregate_stack *astk);
+
+ssize_t aggregate_stack_add(aggregate_stack *astk, aggregate_combine combine, ssize_t *index);
+
+ssize_t aggregate_push(aggregate_stack *astk, TYPE_ELEMENT_STACK value);
+ssize_t aggregate_pop (aggregate_stack *astk, TYPE_ELEMENT_STACK *return_value);
+
+ssize_t aggregate_push_bulk(aggregate_stack *astk, const TYPE_ELEMENT_STACK *values, ssize_t count);
+ssize_t aggregate_pop_bulk (aggregate_stack *astk, ssize_t count);
+
+ssize_t stack_aggregate(const aggregate_stack *astk, ssize_t index, aggregate_t *result);
+ssize_t stack_min(const aggregate_stack *astk, aggregate_t *result);
+ssize_t stack_max(const aggregate_stack *astk, aggregate_t *result);
+ssize_t stack_sum(const aggregate_stack *astk, aggregate_t *result);
+
+#endif  //AGGREGATE_STACK_H_INCLUDED
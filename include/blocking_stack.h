@@ -0,0 +1,33 @@
+#ifndef BLOCKING_STACK_H_INCLUDED
+#define BLOCKING_STACK_H_INCLUDED
+
+#include "stack.h"
+#include <pthread.h>
+
+const ssize_t BLOCKING_SPIN_COUNT = 256;
+const long    WAIT_FOREVER        = -1;
+
+struct blocking_stack {
+    stack                          *stk;
+    ssize_t                         bound;
+    pthread_mutex_t                 lock;
+
+    uint32_t                        not_empty_seq;
+    uint32_t                        not_full_seq;
+    uint32_t                        pop_waiters;
+    uint32_t                        push_waiters;
+};
+
+ssize_t blocking_stack_constructor(blocking_stack *bstk, stack *stk, ssize_t bound);
+ssize_t blocking_stack_destructor(blocking_stack *bstk);
+
+ssize_t try_push(blocking_stack *bstk, TYPE_ELEMENT_STACK value);
+ssize_t try_pop (blocking_stack *bstk, TYPE_ELEMENT_STACK *return_value);
+
+ssize_t push_wait(blocking_stack *bstk, TYPE_ELEMENT_STACK value, long timeout_ms);
+ssize_t pop_wait (blocking_stack *bstk, TYPE_ELEMENT_STACK *return_value, long timeout_ms);
+
+// *pushed is how many of values are on the stack when the call returns, also on a timeout or an error.
+ssize_t push_batch_wait(blocking_stack *bstk, const TYPE_ELEMENT_STACK *values, ssize_t count, long timeout_ms, ssize_t *pushed);
+
+#endif  //BLOCKING_STACK_H_INCLUDED
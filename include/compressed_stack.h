@@ -0,0 +1,40 @@
+#ifndef COMPRESSED_STACK_H_INCLUDED
+#define COMPRESSED_STACK_H_INCLUDED
+
+#include "stack.h"
+
+const ssize_t COMPRESSED_BLOCK_LENGTH = 4096;
+const ssize_t COMPRESSED_HOT_WINDOW   = 2 * COMPRESSED_BLOCK_LENGTH;
+
+struct compressed_block {
+    uint8_t                        *bytes;
+    ssize_t                         length;
+    uint32_t                        hash;
+};
+
+struct compressed_stack {
+    stack                          *hot;
+
+    compressed_block               *blocks;
+    ssize_t                         blocks_count;
+    ssize_t                         blocks_capacity;
+    ssize_t                         compressed_bytes;
+};
+
+struct compressed_statistics {
+    ssize_t                         size;
+    ssize_t                         cold_elements;
+    ssize_t                         compressed_bytes;
+    ssize_t                         hot_bytes;
+};
+
+ssize_t compressed_stack_constructor(compressed_stack *cstk);
+ssize_t compressed_stack_destructor(compressed_stack *cstk);
+
+ssize_t compressed_push(compressed_stack *cstk, TYPE_ELEMENT_STACK value);
+ssize_t compressed_pop (compressed_stack *cstk, TYPE_ELEMENT_STACK *return_value);
+
+ssize_t verify_compressed_stack(const compressed_stack *cstk);
+ssize_t compressed_stack_statistics(const compressed_stack *cstk, compressed_statistics *statistics);
+
+#endif  //COMPRESSED_STACK_H_INCLUDED
@@ -0,0 +1,14 @@
+#ifndef HASH_POOL_H_INCLUDED
+#define HASH_POOL_H_INCLUDED
+
+#include "stack.h"
+
+const ssize_t HASH_CHUNK_SIZE       = 64 * 1024;
+const ssize_t HASH_MAX_THREADS      = 64;
+
+ssize_t  hash_pool_set_threads(ssize_t threads_count);
+ssize_t  hash_pool_get_threads();
+
+uint32_t hash_chunked(const void *array, ssize_t size, uint32_t seed);
+
+#endif  //HASH_POOL_H_INCLUDED
@@ -0,0 +1,54 @@
+#ifndef NUMA_STACK_H_INCLUDED
+#define NUMA_STACK_H_INCLUDED
+
+#include "stack.h"
+#include <pthread.h>
+
+const ssize_t NUMA_MAX_NODES = 64;
+const ssize_t NUMA_MAX_CPUS  = 1024;
+
+enum numa_policy {
+    NUMA_POLICY_DEFAULT     = 0,
+    NUMA_POLICY_FIRST_TOUCH = 1,
+    NUMA_POLICY_EXPLICIT    = 2
+};
+
+struct numa_topology {
+    ssize_t                         nodes_count;
+    ssize_t                         cpus_count;
+    int                             cpu_to_node[NUMA_MAX_CPUS];
+    bool                            is_simulated;
+};
+
+struct numa_statistics {
+    ssize_t                         bind_calls;
+    ssize_t                         bound_bytes;
+    ssize_t                         failed_binds;
+};
+
+struct numa_stack_pool {
+    stack                         **stacks    [NUMA_MAX_NODES];
+    ssize_t                         sizes     [NUMA_MAX_NODES];
+    ssize_t                         capacities[NUMA_MAX_NODES];
+    pthread_mutex_t                 locks     [NUMA_MAX_NODES];
+};
+
+extern numa_policy Global_numa_policy;
+extern int         Global_numa_node;
+
+ssize_t numa_get_topology(numa_topology *topology);
+ssize_t numa_set_simulated_topology(const int *cpu_to_node, ssize_t cpus_count);
+ssize_t numa_reset_topology();
+ssize_t numa_simulate_thread_node(int node);
+
+int     numa_current_node();
+int     numa_choose_node();
+bool    numa_bind_memory(void *memory, size_t size, int node);
+numa_statistics numa_get_statistics();
+
+ssize_t numa_pool_constructor(numa_stack_pool *pool);
+ssize_t numa_pool_destructor(numa_stack_pool *pool);
+stack  *numa_pool_get(numa_stack_pool *pool);
+ssize_t numa_pool_put(numa_stack_pool *pool, stack *stk);
+
+#endif  //NUMA_STACK_H_INCLUDED
@@ -0,0 +1,37 @@
+#ifndef PERSISTENT_STACK_H_INCLUDED
+#define PERSISTENT_STACK_H_INCLUDED
+
+#include "stack.h"
+
+const ssize_t PERSISTENT_NODES_IN_CHUNK = 512;
+
+struct persistent_node {
+    TYPE_ELEMENT_STACK              value;
+    ssize_t                         ref_count;
+    struct persistent_node         *next;
+};
+
+struct persistent_chunk {
+    struct persistent_node          nodes[PERSISTENT_NODES_IN_CHUNK];
+    struct persistent_chunk        *next;
+};
+
+// A version is never changed once made, so versions can be shared between threads and released from any of them.
+// Reference counts are atomic and the node pool is locked; a single persistent_stack variable is not.
+struct persistent_stack {
+    struct persistent_node         *top;
+    ssize_t                         size;
+};
+
+persistent_stack persistent_stack_empty();
+persistent_stack persistent_stack_fork(const persistent_stack *stk);
+
+ssize_t persistent_stack_release(persistent_stack *stk);
+
+ssize_t persistent_push(const persistent_stack *stk, TYPE_ELEMENT_STACK value, persistent_stack *new_version);
+ssize_t persistent_pop (const persistent_stack *stk, TYPE_ELEMENT_STACK *return_value, persistent_stack *new_version);
+ssize_t persistent_top (const persistent_stack *stk, TYPE_ELEMENT_STACK *return_value);
+
+ssize_t persistent_pool_destructor();
+
+#endif  //PERSISTENT_STACK_H_INCLUDED
@@ -0,0 +1,54 @@
+#ifndef SHM_STACK_H_INCLUDED
+#define SHM_STACK_H_INCLUDED
+
+#include "stack.h"
+#include <pthread.h>
+
+const uint32_t SHM_STACK_MAGIC     = 0x4B54534D;
+const uint32_t SHM_STACK_VERSION   = 1;
+
+const ssize_t  SHM_MAX_NAME_LENGTH = 256;
+
+struct shm_stack_state {
+    uint32_t                        magic;
+    uint32_t                        version;
+    int64_t                         element_size;
+    int64_t                         capacity;
+    int64_t                         size;
+    int64_t                         data_offset;
+    int64_t                         segment_size;
+};
+
+struct shm_stack_header {
+    uint64_t                        left_canary;
+
+    shm_stack_state                 state;
+
+    uint32_t                        state_hash;
+    uint32_t                        data_hash;
+    int64_t                         recoveries;
+    pthread_mutex_t                 lock;
+
+    uint64_t                        right_canary;
+};
+
+struct shm_stack {
+    shm_stack_header               *header;
+    size_t                          mapping_size;
+    ssize_t                         error_code;
+    char                            name[SHM_MAX_NAME_LENGTH];
+};
+
+ssize_t shm_stack_constructor(shm_stack *stk, const char *name, ssize_t capacity);
+ssize_t shm_stack_destructor(shm_stack *stk);
+
+ssize_t shm_stack_attach(shm_stack *stk, const char *name);
+ssize_t shm_stack_detach(shm_stack *stk);
+
+ssize_t shm_push(shm_stack *stk, TYPE_ELEMENT_STACK value);
+ssize_t shm_pop (shm_stack *stk, TYPE_ELEMENT_STACK *return_value);
+ssize_t shm_stack_size(shm_stack *stk, ssize_t *size);
+
+ssize_t verify_shm_stack(shm_stack *stk);
+
+#endif  //SHM_STACK_H_INCLUDED
@@ -0,0 +1,40 @@
+#ifndef SPILL_STACK_H_INCLUDED
+#define SPILL_STACK_H_INCLUDED
+
+#include "stack.h"
+#include <pthread.h>
+
+const ssize_t SPILL_NO_SEGMENT = -1;
+
+struct spill_stack {
+    stack                          *hot;
+    ssize_t                         segment_length;
+
+    int                             descriptor;
+    ssize_t                         spilled_count;
+    uint32_t                       *hashes;
+    ssize_t                         hashes_capacity;
+
+    TYPE_ELEMENT_STACK             *prefetch_buffer;
+    pthread_t                       prefetcher;
+    pthread_mutex_t                 lock;
+    pthread_cond_t                  changed;
+    ssize_t                         requested_segment;
+    ssize_t                         loaded_segment;
+    bool                            is_loading;
+    bool                            is_stopping;
+
+    ssize_t                         prefetch_hits;
+    ssize_t                         prefetch_misses;
+};
+
+ssize_t spill_stack_constructor(spill_stack *sstk, const char *file_name, ssize_t memory_budget);
+ssize_t spill_stack_destructor(spill_stack *sstk);
+
+ssize_t spill_push(spill_stack *sstk, TYPE_ELEMENT_STACK value);
+ssize_t spill_pop (spill_stack *sstk, TYPE_ELEMENT_STACK *return_value);
+ssize_t spill_stack_size(const spill_stack *sstk, ssize_t *size);
+
+ssize_t verify_spill_stack(spill_stack *sstk);
+
+#endif  //SPILL_STACK_H_INCLUDED
@@ -7,8 +7,12 @@
 
 extern FILE *Global_logs_pointer;
 extern bool  Global_color_output;
+extern int   Global_dump_descriptor;
 
 #define STACK_CONSTRUCTOR(stk)                                                          \
+    STACK_CONSTRUCTOR_ON_NODE(stk, NUMA_NODE_ANY)
+
+#define STACK_CONSTRUCTOR_ON_NODE(stk, node)                                            \
 do {                                                                                    \
     struct debug_info *info = (debug_info *) calloc(1, sizeof(debug_info));             \
                                                                                         \
@@ -17,7 +21,7 @@ do {
     info->file = __FILE__;                                                              \
     info->func = __PRETTY_FUNCTION__;                                                   \
                                                                                         \
-    stack_constructor(stk, info);                                                       \
+    stack_constructor_on_node(stk, info, node);                                         \
 } while(0)
 
 #ifdef CANARY_PROTECT_INCLUDED
@@ -45,12 +49,25 @@ do {
 
 #endif
 
+#ifdef SANITIZER_POISON_INCLUDED
+
+    #define IF_ON_SANITIZER_POISON(...)         __VA_ARGS__
+    #define ELSE_IF_OFF_SANITIZER_POISON(...)
+
+#else
+
+    #define IF_ON_SANITIZER_POISON(...)
+    #define ELSE_IF_OFF_SANITIZER_POISON(...)   __VA_ARGS__
+
+#endif
+
 #define FORMAT_SPECIFIERS_STACK   "%d"
 typedef int TYPE_ELEMENT_STACK;
 
 const ssize_t  CAPACITY_MULTIPLIER      = 2;
 const ssize_t  INITIAL_CAPACITY_VALUE   = 1;
 const int      POISON                   = 192;
+const int      NUMA_NODE_ANY            = -1;
 
 enum errors_code_stack {
     NO_ERROR                        = 0,
@@ -62,18 +79,20 @@ enum errors_code_stack {
     SIZE_NULL_IN_POP                = 1 <<  5,
     POINTER_TO_STACK_INFO_IS_NULL   = 1 <<  6,
     POINTER_RETURN_VALUE_POP_NULL   = 1 <<  7,
-
-    IF_ON_CANARY_PROTECT(
     LEFT_CANARY_IN_STACK_CHANGED    = 1 <<  8,
     RIGHT_CANARY_IN_STACK_CHANGED   = 1 <<  9,
     LEFT_CANARY_IN_ARRAY_CHANGED    = 1 << 10,
     RIGHT_CANARY_IN_ARRAY_CHANGED   = 1 << 11,
-    )
-
-    IF_ON_HASH_PROTECT(
     STACK_HASH_CHANGED              = 1 << 12,
-    DATA_HASH_CHANGED               = 1 << 13
-    )
+    DATA_HASH_CHANGED               = 1 << 13,
+    INVALID_STACK_MARK              = 1 << 14,
+    STACK_IS_FULL                   = 1 << 15,
+    WAIT_TIMED_OUT                  = 1 << 16,
+    BAD_SHARED_SEGMENT              = 1 << 17,
+    COMPRESSED_BLOCK_DAMAGED        = 1 << 18,
+    SPILL_SEGMENT_DAMAGED           = 1 << 19,
+    POOL_STILL_IN_USE               = 1 << 26,
+    LOCK_INIT_FAILED                = 1 << 27
 };
 
 struct stack {
@@ -82,10 +101,13 @@ struct stack {
     ssize_t                         capacity;
     ssize_t                         error_code;
     struct debug_info              *info;
+    int                             numa_node;
 
     IF_ON_CANARY_PROTECT (canary_t left_canary;)
     IF_ON_CANARY_PROTECT (canary_t right_canary;)
 
+    IF_ON_HASH_PROTECT(ssize_t  hashed_size);
+    IF_ON_HASH_PROTECT(ssize_t  open_end);
     IF_ON_HASH_PROTECT(uint32_t stack_hash);
     IF_ON_HASH_PROTECT(uint32_t data_hash);
 };
@@ -100,9 +122,23 @@ struct debug_info {
 stack *get_pointer_stack();
 
 ssize_t stack_constructor(stack *stk, debug_info *info);
+ssize_t stack_constructor_on_node(stack *stk, debug_info *info, int node);
 ssize_t stack_destructor(stack *stk);
+ssize_t verify_stack(stack *stk);
 
 ssize_t push(stack *stk, TYPE_ELEMENT_STACK value);
 ssize_t pop(stack *stk, TYPE_ELEMENT_STACK *return_value);
 
+ssize_t stack_mark(stack *stk, ssize_t *mark);
+ssize_t stack_rollback(stack *stk, ssize_t mark);
+
+ssize_t stack_reserve(stack *stk, ssize_t count);
+ssize_t stack_open(stack *stk, ssize_t from, ssize_t count);
+ssize_t stack_commit(stack *stk, ssize_t new_size, ssize_t high_water);
+ssize_t stack_commit_open(stack *stk, ssize_t new_size, ssize_t high_water, ssize_t from, ssize_t count);
+
+uint32_t hash_buffer(const void *array, ssize_t size, uint32_t seed);
+uint32_t hash_buffer_update(const void *array, ssize_t size, uint32_t hash);
+uint32_t hash_buffer_finish(uint32_t hash);
+
 #endif  //STACK_H_INCLUDED
@@ -0,0 +1,64 @@
+#ifndef STACK_DUMP_H_INCLUDED
+#define STACK_DUMP_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+const uint32_t STACK_DUMP_MAGIC   = 0x504D4453;
+const uint32_t STACK_DUMP_VERSION = 1;
+const size_t   DUMP_ALIGNMENT     = 8;
+
+enum stack_dump_flags {
+    DUMP_HAS_CANARY     = 1,
+    DUMP_HAS_HASH       = 1 << 1,
+    DUMP_HAS_BITMAP     = 1 << 2
+};
+
+enum stack_dump_canaries {
+    DUMP_LEFT_CANARY_STACK      = 0,
+    DUMP_RIGHT_CANARY_STACK     = 1,
+    DUMP_LEFT_CANARY_ARRAY      = 2,
+    DUMP_RIGHT_CANARY_ARRAY     = 3,
+    DUMP_CANARIES_COUNT         = 4
+};
+
+enum stack_dump_strings {
+    DUMP_STRING_NAME            = 0,
+    DUMP_STRING_FILE            = 1,
+    DUMP_STRING_FUNC            = 2,
+    DUMP_STRING_CALL_FILE       = 3,
+    DUMP_STRING_CALL_FUNC       = 4,
+    DUMP_STRINGS_COUNT          = 5
+};
+
+// Record layout: header, DUMP_STRINGS_COUNT NUL-terminated strings, capacity * element_size bytes of data,
+// (capacity + 7) / 8 bytes of poison bitmap. Strings and the whole record are padded to DUMP_ALIGNMENT.
+struct stack_dump_header {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    flags;
+    uint32_t    element_size;
+
+    uint64_t    record_length;
+    uint64_t    strings_length;
+
+    int64_t     size;
+    int64_t     capacity;
+    int64_t     error_code;
+
+    int64_t     info_line;
+    int64_t     call_line;
+
+    uint64_t    stack_address;
+    uint64_t    data_address;
+    uint64_t    left_canary_array_address;
+    uint64_t    right_canary_array_address;
+
+    int64_t     canaries          [DUMP_CANARIES_COUNT];
+    int64_t     reference_canaries[DUMP_CANARIES_COUNT];
+
+    uint32_t    stack_hash;
+    uint32_t    data_hash;
+};
+
+#endif  //STACK_DUMP_H_INCLUDED
@@ -0,0 +1,95 @@
+#ifndef VM_H_INCLUDED
+#define VM_H_INCLUDED
+
+#include "stack.h"
+
+const uint32_t VM_BYTECODE_MAGIC   = 0x314D5653;
+const uint32_t VM_BYTECODE_VERSION = 1;
+
+const ssize_t  VM_MAX_LABEL_LENGTH = 64;
+
+enum vm_opcode {
+    VM_HLT      = 0,
+    VM_PUSH     = 1,
+    VM_POP      = 2,
+    VM_DUP      = 3,
+    VM_SWAP     = 4,
+    VM_OVER     = 5,
+    VM_ADD      = 6,
+    VM_SUB      = 7,
+    VM_MUL      = 8,
+    VM_DIV      = 9,
+    VM_MOD      = 10,
+    VM_NEG      = 11,
+    VM_EQ       = 12,
+    VM_LT       = 13,
+    VM_JMP      = 14,
+    VM_JZ       = 15,
+    VM_JNZ      = 16,
+    VM_CALL     = 17,
+    VM_RET      = 18,
+    VM_OUT      = 19,
+
+    VM_OPCODES_COUNT
+};
+
+enum vm_error_code {
+    VM_NO_ERROR             = 0,
+    VM_UNKNOWN_OPCODE       = 1 << 20,
+    VM_BAD_JUMP_ADDRESS     = 1 << 21,
+    VM_DIVISION_BY_ZERO     = 1 << 22,
+    VM_STACK_UNDERFLOW      = 1 << 23,
+    VM_SYNTAX_ERROR         = 1 << 24,
+    VM_BAD_BYTECODE         = 1 << 25,
+    VM_ARITHMETIC_OVERFLOW  = 1 << 28
+};
+
+struct vm_instruction {
+    int32_t                         opcode;
+    int32_t                         operand;
+};
+
+struct vm_block {
+    ssize_t                         need;
+    ssize_t                         growth;
+};
+
+struct vm_cell {
+    const void                     *handler;
+    int32_t                         operand;
+};
+
+struct vm_program {
+    vm_instruction                 *code;
+    ssize_t                         length;
+
+    vm_block                       *blocks;
+    vm_cell                        *cells;
+};
+
+struct vm_bytecode_header {
+    uint32_t                        magic;
+    uint32_t                        version;
+    uint32_t                        length;
+    uint32_t                        reserved;
+};
+
+struct vm_machine {
+    stack                          *operands;
+    stack                          *calls;
+    FILE                           *output;
+};
+
+ssize_t vm_assemble(const char *source, vm_program *program, ssize_t *error_line);
+ssize_t vm_save_program(const vm_program *program, const char *file_name);
+ssize_t vm_load_program(const char *file_name, vm_program *program);
+ssize_t vm_program_destructor(vm_program *program);
+
+ssize_t vm_constructor(vm_machine *vm, FILE *output);
+ssize_t vm_destructor(vm_machine *vm);
+
+ssize_t vm_run(vm_machine *vm, vm_program *program);
+ssize_t vm_run_switch(vm_machine *vm, const vm_program *program);
+ssize_t vm_pop_result(vm_machine *vm, TYPE_ELEMENT_STACK *return_value);
+
+#endif  //VM_H_INCLUDED
@@ -0,0 +1,320 @@
+#include "aggregate_stack.h"
+#include "myassert.h"
+#include <string.h>
+
+static ssize_t resize_levels(aggregate_stack *astk, ssize_t capacity);
+static ssize_t fit_levels(aggregate_stack *astk);
+
+static void recompute_levels(aggregate_stack *astk, ssize_t from);
+static void recompute_level(aggregate_stack *astk, ssize_t index, ssize_t from);
+
+ssize_t aggregate_stack_constructor(aggregate_stack *astk)
+{
+    MYASSERT(astk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    astk->stk = get_pointer_stack();
+    MYASSERT(astk->stk != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return POINTER_TO_STACK_IS_NULL);
+
+    STACK_CONSTRUCTOR(astk->stk);
+
+    for (ssize_t index = 0; index < AGGREGATE_MAX_COUNT; index++)
+    {
+        astk->combines[index] = NULL;
+        astk->levels[index]   = NULL;
+    }
+
+    astk->aggregates_count = AGGREGATE_BUILTIN_COUNT;
+    astk->levels_capacity  = 0;
+
+    return astk->stk->error_code | resize_levels(astk, INITIAL_CAPACITY_VALUE);
+}
+
+ssize_t aggregate_stack_destructor(aggregate_stack *astk)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    for (ssize_t index = 0; index < astk->aggregates_count; index++)
+    {
+        free(astk->levels[index]);
+
+        astk->levels[index]   = NULL;
+        astk->combines[index] = NULL;
+    }
+
+    ssize_t error_code = stack_destructor(astk->stk);
+
+    astk->stk              = NULL;
+    astk->aggregates_count = 0;
+    astk->levels_capacity  = 0;
+
+    return error_code;
+}
+
+ssize_t aggregate_stack_add(aggregate_stack *astk, aggregate_combine combine, ssize_t *index)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(combine   != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(index     != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+
+    if (astk->aggregates_count >= AGGREGATE_MAX_COUNT)
+        return SIZE_MORE_THAN_CAPACITY;
+
+    aggregate_t *level = (aggregate_t *) calloc((size_t) astk->levels_capacity, sizeof(aggregate_t));
+
+    if (level == NULL)
+        return POINTER_TO_STACK_DATA_IS_NULL;
+
+    *index = astk->aggregates_count++;
+
+    astk->combines[*index] = combine;
+    astk->levels[*index]   = level;
+
+    recompute_level(astk, *index, 0);
+
+    return NO_ERROR;
+}
+
+ssize_t aggregate_push(aggregate_stack *astk, TYPE_ELEMENT_STACK value)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = push(astk->stk, value);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    error_code = fit_levels(astk);
+
+    // Without room in the levels the element cannot be aggregated, so it is taken back out.
+    if (error_code != NO_ERROR)
+        return error_code | stack_rollback(astk->stk, astk->stk->size - 1);
+
+    recompute_levels(astk, astk->stk->size - 1);
+
+    return NO_ERROR;
+}
+
+ssize_t aggregate_pop(aggregate_stack *astk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(astk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = pop(astk->stk, return_value);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    return fit_levels(astk);
+}
+
+ssize_t aggregate_push_bulk(aggregate_stack *astk, const TYPE_ELEMENT_STACK *values, ssize_t count)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(values    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(count     >= 0,    NEGATIVE_VALUE_SIZE_T,       return SIZE_LESS_THAN_ZERO);
+
+    stack  *stk      = astk->stk;
+    ssize_t old_size = stk->size;
+
+    ssize_t error_code = stack_reserve(stk, count);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    memcpy(stk->data + old_size, values, (size_t) count * sizeof(TYPE_ELEMENT_STACK));
+
+    error_code = stack_commit(stk, old_size + count, old_size + count);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    error_code = fit_levels(astk);
+
+    if (error_code != NO_ERROR)
+        return error_code | stack_rollback(stk, old_size);
+
+    recompute_levels(astk, old_size);
+
+    return NO_ERROR;
+}
+
+ssize_t aggregate_pop_bulk(aggregate_stack *astk, ssize_t count)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(count     >= 0,    NEGATIVE_VALUE_SIZE_T,       return SIZE_LESS_THAN_ZERO);
+
+    if (count > astk->stk->size)
+        return SIZE_NULL_IN_POP;
+
+    ssize_t error_code = stack_rollback(astk->stk, astk->stk->size - count);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    return fit_levels(astk);
+}
+
+ssize_t stack_aggregate(const aggregate_stack *astk, ssize_t index, aggregate_t *result)
+{
+    MYASSERT(result    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (index < 0 || index >= astk->aggregates_count)
+        return SIZE_MORE_THAN_CAPACITY;
+
+    if (astk->stk->size == 0)
+        return SIZE_NULL_IN_POP;
+
+    *result = astk->levels[index][astk->stk->size - 1];
+
+    return NO_ERROR;
+}
+
+ssize_t stack_min(const aggregate_stack *astk, aggregate_t *result)
+{
+    return stack_aggregate(astk, AGGREGATE_MIN, result);
+}
+
+ssize_t stack_max(const aggregate_stack *astk, aggregate_t *result)
+{
+    return stack_aggregate(astk, AGGREGATE_MAX, result);
+}
+
+ssize_t stack_sum(const aggregate_stack *astk, aggregate_t *result)
+{
+    return stack_aggregate(astk, AGGREGATE_SUM, result);
+}
+
+// Every level moves to the new capacity or none does, so levels_capacity always describes all of them.
+ssize_t resize_levels(aggregate_stack *astk, ssize_t capacity)
+{
+    MYASSERT(astk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    aggregate_t *new_levels[AGGREGATE_MAX_COUNT] = {};
+
+    size_t kept_bytes = (size_t) ((capacity < astk->levels_capacity) ? capacity : astk->levels_capacity) * sizeof(aggregate_t);
+
+    for (ssize_t index = 0; index < astk->aggregates_count; index++)
+    {
+        new_levels[index] = (aggregate_t *) malloc((size_t) capacity * sizeof(aggregate_t));
+
+        if (new_levels[index] == NULL)
+        {
+            for (ssize_t allocated = 0; allocated < index; allocated++)
+                free(new_levels[allocated]);
+
+            return POINTER_TO_STACK_DATA_IS_NULL;
+        }
+
+        if (kept_bytes > 0)
+            memcpy(new_levels[index], astk->levels[index], kept_bytes);
+    }
+
+    for (ssize_t index = 0; index < astk->aggregates_count; index++)
+    {
+        free(astk->levels[index]);
+
+        astk->levels[index] = new_levels[index];
+    }
+
+    astk->levels_capacity = capacity;
+
+    return NO_ERROR;
+}
+
+// Levels follow the element buffer: they double when the stack outgrows them and halve once it drops to a quarter.
+ssize_t fit_levels(aggregate_stack *astk)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t size     = astk->stk->size;
+    ssize_t capacity = astk->levels_capacity;
+
+    while (size > capacity)
+        capacity *= CAPACITY_MULTIPLIER;
+
+    while (capacity > INITIAL_CAPACITY_VALUE && (size + 1) * CAPACITY_MULTIPLIER * CAPACITY_MULTIPLIER <= capacity)
+        capacity /= CAPACITY_MULTIPLIER;
+
+    if (capacity == astk->levels_capacity)
+        return NO_ERROR;
+
+    return resize_levels(astk, capacity);
+}
+
+void recompute_levels(aggregate_stack *astk, ssize_t from)
+{
+    MYASSERT(astk != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    for (ssize_t index = 0; index < astk->aggregates_count; index++)
+        recompute_level(astk, index, from);
+}
+
+// Built-in aggregates get their own loops so the running value stays in a register and no call is made per element.
+void recompute_level(aggregate_stack *astk, ssize_t index, ssize_t from)
+{
+    MYASSERT(astk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(astk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    const TYPE_ELEMENT_STACK *data  = astk->stk->data;
+    ssize_t                   size  = astk->stk->size;
+    aggregate_t              *level = astk->levels[index];
+
+    if (from >= size)
+        return;
+
+    if (from == 0)
+    {
+        level[0] = data[0];
+        from     = 1;
+    }
+
+    aggregate_t accumulated = level[from - 1];
+
+    switch (index)
+    {
+        case AGGREGATE_MIN:
+            for (ssize_t counter = from; counter < size; counter++)
+            {
+                accumulated    = (data[counter] < accumulated) ? data[counter] : accumulated;
+                level[counter] = accumulated;
+            }
+            break;
+
+        case AGGREGATE_MAX:
+            for (ssize_t counter = from; counter < size; counter++)
+            {
+                accumulated    = (data[counter] > accumulated) ? data[counter] : accumulated;
+                level[counter] = accumulated;
+            }
+            break;
+
+        case AGGREGATE_SUM:
+            for (ssize_t counter = from; counter < size; counter++)
+            {
+                accumulated   += data[counter];
+                level[counter] = accumulated;
+            }
+            break;
+
+        default:
+        {
+            aggregate_combine combine = astk->combines[index];
+
+            for (ssize_t counter = from; counter < size; counter++)
+            {
+                accumulated    = combine(accumulated, data[counter]);
+                level[counter] = accumulated;
+            }
+            break;
+        }
+    }
+}
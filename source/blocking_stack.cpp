@@ -0,0 +1,265 @@
+#include "blocking_stack.h"
+#include "myassert.h"
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+static ssize_t push_locked(blocking_stack *bstk, const TYPE_ELEMENT_STACK *values, ssize_t count, ssize_t *pushed);
+
+static ssize_t wait_for_change(uint32_t *seq, uint32_t seen, uint32_t *waiters, const timespec *deadline);
+static void notify(uint32_t *seq, uint32_t *waiters, ssize_t count);
+
+static bool get_deadline(long timeout_ms, timespec *deadline);
+static bool get_remaining_time(const timespec *deadline, timespec *remaining);
+
+static void cpu_relax();
+
+ssize_t blocking_stack_constructor(blocking_stack *bstk, stack *stk, ssize_t bound)
+{
+    MYASSERT(bstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(bound > 0,         NEGATIVE_VALUE_SIZE_T,       return CAPACITY_LESS_THAN_ZERO);
+
+    bstk->stk           = stk;
+    bstk->bound         = bound;
+
+    bstk->not_empty_seq = 0;
+    bstk->not_full_seq  = 0;
+    bstk->pop_waiters   = 0;
+    bstk->push_waiters  = 0;
+
+    if (pthread_mutex_init(&bstk->lock, NULL) != 0)
+        return LOCK_INIT_FAILED;
+
+    return NO_ERROR;
+}
+
+ssize_t blocking_stack_destructor(blocking_stack *bstk)
+{
+    MYASSERT(bstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(bstk->stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    pthread_mutex_destroy(&bstk->lock);
+
+    ssize_t error_code = stack_destructor(bstk->stk);
+
+    bstk->stk   = NULL;
+    bstk->bound = 0;
+
+    return error_code;
+}
+
+ssize_t try_push(blocking_stack *bstk, TYPE_ELEMENT_STACK value)
+{
+    MYASSERT(bstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t pushed = 0;
+
+    ssize_t error_code = push_locked(bstk, &value, 1, &pushed);
+
+    if (error_code == NO_ERROR && pushed == 0)
+        return STACK_IS_FULL;
+
+    return error_code;
+}
+
+ssize_t try_pop(blocking_stack *bstk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(bstk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    pthread_mutex_lock(&bstk->lock);
+
+    ssize_t error_code = pop(bstk->stk, return_value);
+
+    pthread_mutex_unlock(&bstk->lock);
+
+    if (error_code == NO_ERROR)
+        notify(&bstk->not_full_seq, &bstk->push_waiters, 1);
+
+    return error_code;
+}
+
+ssize_t push_wait(blocking_stack *bstk, TYPE_ELEMENT_STACK value, long timeout_ms)
+{
+    ssize_t pushed = 0;
+
+    return push_batch_wait(bstk, &value, 1, timeout_ms, &pushed);
+}
+
+ssize_t pop_wait(blocking_stack *bstk, TYPE_ELEMENT_STACK *return_value, long timeout_ms)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(bstk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    timespec deadline = {};
+    bool has_deadline = get_deadline(timeout_ms, &deadline);
+
+    while (true)
+    {
+        uint32_t seen = __atomic_load_n(&bstk->not_empty_seq, __ATOMIC_SEQ_CST);
+
+        ssize_t error_code = try_pop(bstk, return_value);
+
+        if (error_code != SIZE_NULL_IN_POP)
+            return error_code;
+
+        if (wait_for_change(&bstk->not_empty_seq, seen, &bstk->pop_waiters, has_deadline ? &deadline : NULL) != NO_ERROR)
+            return WAIT_TIMED_OUT;
+    }
+}
+
+ssize_t push_batch_wait(blocking_stack *bstk, const TYPE_ELEMENT_STACK *values, ssize_t count, long timeout_ms, ssize_t *pushed)
+{
+    MYASSERT(values != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(bstk   != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(pushed != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(count  >= 0,    NEGATIVE_VALUE_SIZE_T,       return SIZE_LESS_THAN_ZERO);
+
+    timespec deadline = {};
+    bool has_deadline = get_deadline(timeout_ms, &deadline);
+
+    *pushed = 0;
+
+    while (*pushed < count)
+    {
+        uint32_t seen  = __atomic_load_n(&bstk->not_full_seq, __ATOMIC_SEQ_CST);
+        ssize_t  added = 0;
+
+        ssize_t error_code = push_locked(bstk, values + *pushed, count - *pushed, &added);
+
+        *pushed += added;
+
+        if (error_code != NO_ERROR)
+            return error_code;
+
+        if (added == 0 &&
+            wait_for_change(&bstk->not_full_seq, seen, &bstk->push_waiters, has_deadline ? &deadline : NULL) != NO_ERROR)
+            return WAIT_TIMED_OUT;
+    }
+
+    return NO_ERROR;
+}
+
+ssize_t push_locked(blocking_stack *bstk, const TYPE_ELEMENT_STACK *values, ssize_t count, ssize_t *pushed)
+{
+    MYASSERT(bstk   != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(values != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(pushed != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = NO_ERROR;
+
+    *pushed = 0;
+
+    pthread_mutex_lock(&bstk->lock);
+
+    while (*pushed < count && bstk->stk->size < bstk->bound)
+    {
+        if ((error_code = push(bstk->stk, values[*pushed])) != NO_ERROR)
+            break;
+
+        (*pushed)++;
+    }
+
+    pthread_mutex_unlock(&bstk->lock);
+
+    if (*pushed > 0)
+        notify(&bstk->not_empty_seq, &bstk->pop_waiters, *pushed);
+
+    return error_code;
+}
+
+ssize_t wait_for_change(uint32_t *seq, uint32_t seen, uint32_t *waiters, const timespec *deadline)
+{
+    MYASSERT(seq     != NULL, NULL_POINTER_PASSED_TO_FUNC, return WAIT_TIMED_OUT);
+    MYASSERT(waiters != NULL, NULL_POINTER_PASSED_TO_FUNC, return WAIT_TIMED_OUT);
+
+    for (ssize_t spin = 0; spin < BLOCKING_SPIN_COUNT; spin++)
+    {
+        if (__atomic_load_n(seq, __ATOMIC_ACQUIRE) != seen)
+            return NO_ERROR;
+
+        cpu_relax();
+    }
+
+    timespec remaining = {};
+
+    if (deadline != NULL && !get_remaining_time(deadline, &remaining))
+        return WAIT_TIMED_OUT;
+
+    __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+
+    syscall(SYS_futex, seq, FUTEX_WAIT_PRIVATE, seen, deadline != NULL ? &remaining : NULL, NULL, 0);
+
+    __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+
+    return NO_ERROR;
+}
+
+void notify(uint32_t *seq, uint32_t *waiters, ssize_t count)
+{
+    MYASSERT(seq     != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(waiters != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    __atomic_add_fetch(seq, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) == 0)
+        return;
+
+    int wake_count = (count < INT_MAX) ? (int) count : INT_MAX;
+
+    syscall(SYS_futex, seq, FUTEX_WAKE_PRIVATE, wake_count, NULL, NULL, 0);
+}
+
+bool get_deadline(long timeout_ms, timespec *deadline)
+{
+    MYASSERT(deadline != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    if (timeout_ms < 0)
+        return false;
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+
+    deadline->tv_sec  += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000;
+
+    if (deadline->tv_nsec >= 1000000000)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+
+    return true;
+}
+
+bool get_remaining_time(const timespec *deadline, timespec *remaining)
+{
+    MYASSERT(deadline  != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(remaining != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    remaining->tv_sec  = deadline->tv_sec  - now.tv_sec;
+    remaining->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+
+    if (remaining->tv_nsec < 0)
+    {
+        remaining->tv_sec--;
+        remaining->tv_nsec += 1000000000;
+    }
+
+    return remaining->tv_sec >= 0;
+}
+
+void cpu_relax()
+{
+    #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+    #else
+        __asm__ __volatile__("" ::: "memory");
+    #endif
+}
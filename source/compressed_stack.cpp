@@ -0,0 +1,333 @@
+#include "compressed_stack.h"
+#include "myassert.h"
+#include <string.h>
+
+const ssize_t MAX_VARINT_LENGTH = 10;
+
+static ssize_t compress_bottom(compressed_stack *cstk);
+static ssize_t decompress_top(compressed_stack *cstk);
+static ssize_t check_block(const compressed_block *block, ssize_t index);
+
+static ssize_t encode_block(const TYPE_ELEMENT_STACK *values, ssize_t count, uint8_t *bytes);
+static bool    decode_block(const uint8_t *bytes, ssize_t length, TYPE_ELEMENT_STACK *values, ssize_t count);
+static ssize_t put_varint(uint64_t value, uint8_t *bytes);
+static bool    get_varint(const uint8_t *bytes, ssize_t length, ssize_t *position, uint64_t *value);
+
+ssize_t compressed_stack_constructor(compressed_stack *cstk)
+{
+    MYASSERT(cstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    cstk->hot = get_pointer_stack();
+    MYASSERT(cstk->hot != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return POINTER_TO_STACK_IS_NULL);
+
+    STACK_CONSTRUCTOR(cstk->hot);
+
+    cstk->blocks           = NULL;
+    cstk->blocks_count     = 0;
+    cstk->blocks_capacity  = 0;
+    cstk->compressed_bytes = 0;
+
+    return cstk->hot->error_code;
+}
+
+ssize_t compressed_stack_destructor(compressed_stack *cstk)
+{
+    MYASSERT(cstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    for (ssize_t index = 0; index < cstk->blocks_count; index++)
+        free(cstk->blocks[index].bytes);
+
+    free(cstk->blocks);
+
+    ssize_t error_code = stack_destructor(cstk->hot);
+
+    cstk->hot              = NULL;
+    cstk->blocks           = NULL;
+    cstk->blocks_count     = 0;
+    cstk->blocks_capacity  = 0;
+    cstk->compressed_bytes = 0;
+
+    return error_code;
+}
+
+ssize_t compressed_push(compressed_stack *cstk, TYPE_ELEMENT_STACK value)
+{
+    MYASSERT(cstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = push(cstk->hot, value);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    if (cstk->hot->size >= COMPRESSED_HOT_WINDOW)
+        return compress_bottom(cstk);
+
+    return NO_ERROR;
+}
+
+ssize_t compressed_pop(compressed_stack *cstk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(cstk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (cstk->hot->size == 0 && cstk->blocks_count > 0)
+    {
+        ssize_t error_code = decompress_top(cstk);
+
+        if (error_code != NO_ERROR)
+            return error_code;
+    }
+
+    return pop(cstk->hot, return_value);
+}
+
+ssize_t verify_compressed_stack(const compressed_stack *cstk)
+{
+    MYASSERT(cstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = verify_stack(cstk->hot);
+
+    for (ssize_t index = 0; index < cstk->blocks_count; index++)
+        error_code |= check_block(cstk->blocks + index, index);
+
+    return error_code;
+}
+
+ssize_t compressed_stack_statistics(const compressed_stack *cstk, compressed_statistics *statistics)
+{
+    MYASSERT(cstk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(statistics != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+
+    statistics->cold_elements    = cstk->blocks_count * COMPRESSED_BLOCK_LENGTH;
+    statistics->size             = statistics->cold_elements + cstk->hot->size;
+    statistics->compressed_bytes = cstk->compressed_bytes + cstk->blocks_capacity * (ssize_t) sizeof(compressed_block);
+    statistics->hot_bytes        = cstk->hot->capacity * (ssize_t) sizeof(TYPE_ELEMENT_STACK);
+
+    return NO_ERROR;
+}
+
+ssize_t compress_bottom(compressed_stack *cstk)
+{
+    MYASSERT(cstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    stack *hot = cstk->hot;
+
+    if (cstk->blocks_count >= cstk->blocks_capacity)
+    {
+        ssize_t           capacity   = (cstk->blocks_capacity > 0) ? cstk->blocks_capacity * CAPACITY_MULTIPLIER : INITIAL_CAPACITY_VALUE;
+        compressed_block *new_blocks = (compressed_block *) realloc(cstk->blocks, (size_t) capacity * sizeof(compressed_block));
+
+        if (new_blocks == NULL)
+            return POINTER_TO_STACK_DATA_IS_NULL;
+
+        cstk->blocks          = new_blocks;
+        cstk->blocks_capacity = capacity;
+    }
+
+    uint8_t *bytes = (uint8_t *) malloc((size_t) (COMPRESSED_BLOCK_LENGTH * MAX_VARINT_LENGTH));
+
+    if (bytes == NULL)
+        return POINTER_TO_STACK_DATA_IS_NULL;
+
+    // The bottom block leaves by shifting the whole window down, so all of it is opened up to the commit.
+    ssize_t error_code = stack_open(hot, 0, 0);
+
+    if (error_code != NO_ERROR)
+    {
+        free(bytes);
+        return error_code;
+    }
+
+    ssize_t length = encode_block(hot->data, COMPRESSED_BLOCK_LENGTH, bytes);
+
+    uint8_t *block_bytes = (uint8_t *) realloc(bytes, (size_t) length);
+
+    if (block_bytes != NULL)
+        bytes = block_bytes;
+
+    ssize_t old_size = hot->size;
+
+    memmove(hot->data, hot->data + COMPRESSED_BLOCK_LENGTH, (size_t) (old_size - COMPRESSED_BLOCK_LENGTH) * sizeof(TYPE_ELEMENT_STACK));
+
+    error_code = stack_commit(hot, old_size - COMPRESSED_BLOCK_LENGTH, old_size);
+
+    // The block is published only once the hot stack has let go of it, so a failed commit never counts it twice.
+    if (error_code != NO_ERROR)
+    {
+        free(bytes);
+        return error_code;
+    }
+
+    compressed_block *block = cstk->blocks + cstk->blocks_count;
+
+    block->bytes  = bytes;
+    block->length = length;
+    block->hash   = hash_buffer(bytes, length, (uint32_t) cstk->blocks_count);
+
+    cstk->blocks_count++;
+    cstk->compressed_bytes += length;
+
+    return NO_ERROR;
+}
+
+ssize_t decompress_top(compressed_stack *cstk)
+{
+    MYASSERT(cstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(cstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t           index = cstk->blocks_count - 1;
+    compressed_block *block = cstk->blocks + index;
+
+    ssize_t error_code = check_block(block, index);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    error_code = stack_reserve(cstk->hot, COMPRESSED_BLOCK_LENGTH);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    if (!decode_block(block->bytes, block->length, cstk->hot->data, COMPRESSED_BLOCK_LENGTH))
+        return COMPRESSED_BLOCK_DAMAGED;
+
+    error_code = stack_commit(cstk->hot, COMPRESSED_BLOCK_LENGTH, 0);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    cstk->compressed_bytes -= block->length;
+    cstk->blocks_count--;
+
+    free(block->bytes);
+    block->bytes = NULL;
+
+    return NO_ERROR;
+}
+
+ssize_t check_block(const compressed_block *block, ssize_t index)
+{
+    MYASSERT(block        != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(block->bytes != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    if (block->length <= 0 || block->hash != hash_buffer(block->bytes, block->length, (uint32_t) index))
+        return COMPRESSED_BLOCK_DAMAGED;
+
+    return NO_ERROR;
+}
+
+// Elements are stored as zigzag-encoded differences from the previous one in base-128 varint form. A run of
+// equal differences is one token: the low bit of the difference says a varint with the run length follows.
+// A repeated value or a constant step costs a few bytes per run, and a lone element costs a byte at best.
+ssize_t encode_block(const TYPE_ELEMENT_STACK *values, ssize_t count, uint8_t *bytes)
+{
+    MYASSERT(values != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+    MYASSERT(bytes  != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+
+    int64_t previous = 0;
+    ssize_t length   = 0;
+
+    for (ssize_t index = 0; index < count; )
+    {
+        int64_t delta = (int64_t) values[index] - previous;
+        ssize_t run   = 1;
+
+        while (index + run < count && (int64_t) values[index + run] - values[index + run - 1] == delta)
+            run++;
+
+        uint64_t zigzag = ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);
+
+        length += put_varint((zigzag << 1) | (run > 1), bytes + length);
+
+        if (run > 1)
+            length += put_varint((uint64_t) (run - 2), bytes + length);
+
+        previous = values[index + run - 1];
+        index   += run;
+    }
+
+    return length;
+}
+
+bool decode_block(const uint8_t *bytes, ssize_t length, TYPE_ELEMENT_STACK *values, ssize_t count)
+{
+    MYASSERT(bytes  != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(values != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    uint64_t previous = 0;
+    ssize_t  position = 0;
+
+    for (ssize_t index = 0; index < count; )
+    {
+        uint64_t token = 0;
+        uint64_t run   = 1;
+
+        if (!get_varint(bytes, length, &position, &token))
+            return false;
+
+        if ((token & 1) && !get_varint(bytes, length, &position, &run))
+            return false;
+
+        if (token & 1)
+            run += 2;
+
+        if (run > (uint64_t) (count - index))
+            return false;
+
+        uint64_t zigzag = token >> 1;
+        uint64_t delta  = (zigzag >> 1) ^ -(zigzag & 1);
+
+        for (uint64_t element = 0; element < run; element++)
+        {
+            previous += delta;
+
+            values[index++] = (TYPE_ELEMENT_STACK) previous;
+        }
+    }
+
+    return position == length;
+}
+
+ssize_t put_varint(uint64_t value, uint8_t *bytes)
+{
+    MYASSERT(bytes != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+
+    ssize_t length = 0;
+
+    while (value >= 0x80)
+    {
+        bytes[length++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+
+    bytes[length++] = (uint8_t) value;
+
+    return length;
+}
+
+bool get_varint(const uint8_t *bytes, ssize_t length, ssize_t *position, uint64_t *value)
+{
+    MYASSERT(bytes    != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(position != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(value    != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    int shift = 0;
+
+    *value = 0;
+
+    do {
+        if (*position >= length || shift >= 64)
+            return false;
+
+        *value |= (uint64_t) (bytes[*position] & 0x7F) << shift;
+        shift  += 7;
+    } while (bytes[(*position)++] & 0x80);
+
+    return true;
+}
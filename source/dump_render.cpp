@@ -0,0 +1,584 @@
+#include "stack.h"
+#include "stack_dump.h"
+#include "myassert.h"
+#include "utilities.h"
+#include <string.h>
+
+FILE *Global_logs_pointer = stdout;
+bool  Global_color_output = true;
+
+struct dump_file {
+    char                           *buffer;
+    size_t                          length;
+};
+
+struct dump_record {
+    const stack_dump_header        *header;
+    const char                     *strings[DUMP_STRINGS_COUNT];
+    const TYPE_ELEMENT_STACK       *data;
+    const uint8_t                  *bitmap;
+};
+
+struct render_options {
+    const char                     *dump_file_name;
+    const char                     *diff_file_name;
+    const char                     *output_file_name;
+    ssize_t                         record_index;
+    ssize_t                         range_from;
+    ssize_t                         range_to;
+};
+
+struct error_name {
+    int64_t                         code;
+    const char                     *name;
+};
+
+#define ERROR_NAME_(code)   {code, #code}
+
+const error_name ERROR_NAMES[] = {
+    ERROR_NAME_(POINTER_TO_STACK_IS_NULL),
+    ERROR_NAME_(POINTER_TO_STACK_DATA_IS_NULL),
+    ERROR_NAME_(SIZE_MORE_THAN_CAPACITY),
+    ERROR_NAME_(CAPACITY_LESS_THAN_ZERO),
+    ERROR_NAME_(SIZE_LESS_THAN_ZERO),
+    ERROR_NAME_(SIZE_NULL_IN_POP),
+    ERROR_NAME_(POINTER_TO_STACK_INFO_IS_NULL),
+    ERROR_NAME_(POINTER_RETURN_VALUE_POP_NULL),
+    ERROR_NAME_(LEFT_CANARY_IN_STACK_CHANGED),
+    ERROR_NAME_(RIGHT_CANARY_IN_STACK_CHANGED),
+    ERROR_NAME_(LEFT_CANARY_IN_ARRAY_CHANGED),
+    ERROR_NAME_(RIGHT_CANARY_IN_ARRAY_CHANGED),
+    ERROR_NAME_(STACK_HASH_CHANGED),
+    ERROR_NAME_(DATA_HASH_CHANGED),
+    ERROR_NAME_(INVALID_STACK_MARK),
+    ERROR_NAME_(STACK_IS_FULL),
+    ERROR_NAME_(WAIT_TIMED_OUT),
+    ERROR_NAME_(BAD_SHARED_SEGMENT),
+    ERROR_NAME_(COMPRESSED_BLOCK_DAMAGED),
+    ERROR_NAME_(SPILL_SEGMENT_DAMAGED),
+    ERROR_NAME_(POOL_STILL_IN_USE),
+    ERROR_NAME_(LOCK_INIT_FAILED)
+};
+
+#undef ERROR_NAME_
+
+static bool parse_options(int argc, const char *argv[], render_options *options);
+static void print_usage(const char *program_name);
+
+static bool read_dump_file(const char *file_name, dump_file *file);
+static bool get_record(const dump_file *file, ssize_t record_index, dump_record *record, size_t *offset);
+
+static void render_record(const dump_record *record, const render_options *options);
+static void print_errors(const dump_record *record);
+static void print_debug_info(const dump_record *record);
+static void print_canary(int64_t canary, int64_t reference_value_canary);
+static void print_element(const dump_record *record, ssize_t index);
+
+static void diff_records(const dump_record *old_record, const dump_record *new_record, const render_options *options);
+static void diff_field(const char *name, int64_t old_value, int64_t new_value);
+
+static bool is_poison(const dump_record *record, ssize_t index);
+static void get_range(const dump_record *record, const render_options *options, ssize_t *from, ssize_t *to);
+static void *get_address(uint64_t address);
+
+int main(int argc, const char *argv[])
+{
+    render_options options = {};
+
+    if (!parse_options(argc, argv, &options))
+    {
+        print_usage(argv[0]);
+        return INCORRECT_NUMBER_OF_ARGC;
+    }
+
+    dump_file file      = {};
+    dump_file diff_file = {};
+
+    if (!read_dump_file(options.dump_file_name, &file))
+        return COULD_NOT_OPEN_THE_FILE;
+
+    if (options.diff_file_name != NULL && !read_dump_file(options.diff_file_name, &diff_file))
+    {
+        free(file.buffer);
+        return COULD_NOT_OPEN_THE_FILE;
+    }
+
+    if (options.output_file_name != NULL)
+    {
+        Global_logs_pointer = check_isopen(options.output_file_name, "w");
+        MYASSERT(Global_logs_pointer != NULL, COULD_NOT_OPEN_THE_FILE, return COULD_NOT_OPEN_THE_FILE);
+
+        if (Global_logs_pointer == NULL)
+            return COULD_NOT_OPEN_THE_FILE;
+    }
+
+    #ifndef CONSOLE_OUTPUT
+        fprintf(Global_logs_pointer, "<pre>\n");
+    #endif
+
+    dump_record record = {};
+    size_t      offset = 0;
+
+    if (options.diff_file_name != NULL)
+    {
+        dump_record new_record = {};
+        size_t      new_offset = 0;
+
+        ssize_t record_index = (options.record_index >= 0) ? options.record_index : 0;
+
+        if (get_record(&file, record_index, &record, &offset) && get_record(&diff_file, record_index, &new_record, &new_offset))
+            diff_records(&record, &new_record, &options);
+
+        else
+            fprintf(stderr, "ERROR! Record %ld not found in both dumps\n", record_index);
+    }
+
+    else if (options.record_index >= 0)
+    {
+        if (get_record(&file, options.record_index, &record, &offset))
+            render_record(&record, &options);
+
+        else
+            fprintf(stderr, "ERROR! Record %ld not found\n", options.record_index);
+    }
+
+    else
+    {
+        while (get_record(&file, 0, &record, &offset))
+            render_record(&record, &options);
+    }
+
+    #ifndef CONSOLE_OUTPUT
+        fprintf(Global_logs_pointer, "</pre>\n");
+    #endif
+
+    free(file.buffer);
+    free(diff_file.buffer);
+
+    if (options.output_file_name != NULL)
+    {
+        bool is_closed = check_isclose(Global_logs_pointer);
+        MYASSERT(is_closed, COULD_NOT_CLOSE_THE_FILE, return COULD_NOT_CLOSE_THE_FILE);
+
+        if (!is_closed)
+            return COULD_NOT_CLOSE_THE_FILE;
+    }
+
+    return 0;
+}
+
+bool parse_options(int argc, const char *argv[], render_options *options)
+{
+    MYASSERT(argv    != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(options != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    if (argc < 2)
+        return false;
+
+    options->dump_file_name   = argv[1];
+    options->diff_file_name   = NULL;
+    options->output_file_name = NULL;
+    options->record_index     = -1;
+    options->range_from       = 0;
+    options->range_to         = -1;
+
+    for (int index = 2; index < argc; index++)
+    {
+        bool has_value = (index + 1 < argc);
+
+        if (strcmp(argv[index], "--no-color") == 0)
+            Global_color_output = false;
+
+        else if (strcmp(argv[index], "--diff") == 0 && has_value)
+            options->diff_file_name = argv[++index];
+
+        else if (strcmp(argv[index], "--output") == 0 && has_value)
+            options->output_file_name = argv[++index];
+
+        else if (strcmp(argv[index], "--record") == 0 && has_value)
+            options->record_index = strtol(argv[++index], NULL, 10);
+
+        else if (strcmp(argv[index], "--range") == 0 && index + 2 < argc)
+        {
+            options->range_from = strtol(argv[++index], NULL, 10);
+            options->range_to   = strtol(argv[++index], NULL, 10);
+        }
+
+        else
+            return false;
+    }
+
+    return true;
+}
+
+void print_usage(const char *program_name)
+{
+    printf("Usage: %s <dump file> [--record N] [--range FROM TO] [--diff <dump file>] [--output <file>] [--no-color]\n",
+           program_name);
+}
+
+bool read_dump_file(const char *file_name, dump_file *file)
+{
+    MYASSERT(file_name != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(file      != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    FILE *file_pointer = check_isopen(file_name, "rb");
+
+    if (file_pointer == NULL)
+        return false;
+
+    fseek(file_pointer, 0, SEEK_END);
+    long length = ftell(file_pointer);
+    fseek(file_pointer, 0, SEEK_SET);
+
+    file->length = (length > 0) ? (size_t) length : 0;
+    file->buffer = (char *) calloc(file->length + 1, 1);
+
+    bool is_read = (file->buffer != NULL && fread(file->buffer, 1, file->length, file_pointer) == file->length);
+
+    check_isclose(file_pointer);
+
+    if (!is_read)
+    {
+        fprintf(stderr, "ERROR! Could not read the dump \"%s\"\n", file_name);
+
+        free(file->buffer);
+        file->buffer = NULL;
+    }
+
+    return is_read;
+}
+
+bool get_record(const dump_file *file, ssize_t record_index, dump_record *record, size_t *offset)
+{
+    MYASSERT(file   != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(record != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(offset != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    for (ssize_t skipped = 0; ; skipped++)
+    {
+        if (file->length - *offset < sizeof(stack_dump_header))
+            return false;
+
+        const char              *begin  = file->buffer + *offset;
+        const stack_dump_header *header = (const stack_dump_header *) begin;
+
+        if (header->magic != STACK_DUMP_MAGIC || header->version != STACK_DUMP_VERSION ||
+            header->element_size != sizeof(TYPE_ELEMENT_STACK) ||
+            header->record_length > file->length - *offset || header->record_length < sizeof(stack_dump_header) ||
+            header->capacity < 0)
+        {
+            fprintf(stderr, "ERROR! Damaged or incompatible record at offset %zu\n", *offset);
+            return false;
+        }
+
+        *offset += header->record_length;
+
+        if (skipped < record_index)
+            continue;
+
+        // Both lengths come from the file, so they are bounded by the record before anything is multiplied or added.
+        size_t remaining = header->record_length - sizeof(stack_dump_header);
+
+        if (header->strings_length > remaining ||
+            (uint64_t) header->capacity > (remaining - header->strings_length) / sizeof(TYPE_ELEMENT_STACK))
+        {
+            fprintf(stderr, "ERROR! Record length does not match its header\n");
+            return false;
+        }
+
+        size_t capacity      = (size_t) header->capacity;
+        size_t bitmap_length = (header->flags & DUMP_HAS_BITMAP) ? (capacity + 7) / 8 : 0;
+
+        size_t record_length = sizeof(stack_dump_header) + header->strings_length + capacity * sizeof(TYPE_ELEMENT_STACK) +
+                               bitmap_length;
+
+        if (header->strings_length % DUMP_ALIGNMENT != 0 ||
+            record_length + (DUMP_ALIGNMENT - record_length % DUMP_ALIGNMENT) % DUMP_ALIGNMENT != header->record_length)
+        {
+            fprintf(stderr, "ERROR! Record length does not match its header\n");
+            return false;
+        }
+
+        const char *strings     = begin + sizeof(stack_dump_header);
+        const char *strings_end = strings + header->strings_length;
+
+        for (int index = 0; index < DUMP_STRINGS_COUNT; index++)
+        {
+            const char *end = (const char *) memchr(strings, '\0', (size_t) (strings_end - strings));
+
+            if (end == NULL)
+                return false;
+
+            record->strings[index] = strings;
+            strings = end + 1;
+        }
+
+        record->header = header;
+        record->data   = (const TYPE_ELEMENT_STACK *) strings_end;
+        record->bitmap = (bitmap_length > 0) ? (const uint8_t *) (strings_end + capacity * sizeof(TYPE_ELEMENT_STACK)) : NULL;
+
+        return true;
+    }
+}
+
+void render_record(const dump_record *record, const render_options *options)
+{
+    MYASSERT(record  != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(options != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    const stack_dump_header *header = record->header;
+
+    print_errors(record);
+
+    print_debug_info(record);
+
+    ssize_t from = 0;
+    ssize_t to   = 0;
+
+    get_range(record, options, &from, &to);
+
+    if (from > 0)
+        fprintf(Global_logs_pointer, "\t\t ... (%ld elements skipped)\n", from);
+
+    for (ssize_t index = from; index < to; index++)
+        print_element(record, index);
+
+    if (to < header->capacity)
+        fprintf(Global_logs_pointer, "\t\t ... (%ld elements skipped)\n", header->capacity - to);
+
+    if (header->flags & DUMP_HAS_CANARY)
+    {
+        fprintf(Global_logs_pointer, "\t\t [right_canary] = ");
+
+        print_canary(header->canaries[DUMP_RIGHT_CANARY_ARRAY], header->reference_canaries[DUMP_RIGHT_CANARY_ARRAY]);
+
+        COLOR_PRINT(DarkViolet, "[%p]\n", get_address(header->right_canary_array_address));
+    }
+
+    fprintf(Global_logs_pointer,  "\t}\n"
+                                "}\n\n");
+}
+
+void print_errors(const dump_record *record)
+{
+    MYASSERT(record != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    for (size_t index = 0; index < sizeof(ERROR_NAMES) / sizeof(ERROR_NAMES[0]); index++)
+    {
+        if (record->header->error_code & ERROR_NAMES[index].code)
+            COLOR_PRINT(Red, "Errors: %s\n", ERROR_NAMES[index].name);
+    }
+}
+
+void print_debug_info(const dump_record *record)
+{
+    MYASSERT(record != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    const stack_dump_header *header = record->header;
+
+    COLOR_PRINT(MediumBlue, "stack[%p]\n", get_address(header->stack_address));
+
+    COLOR_PRINT(BlueViolet, "\"%s\"from %s(%ld) %s\n", record->strings[DUMP_STRING_NAME], record->strings[DUMP_STRING_FILE],
+                                                       header->info_line, record->strings[DUMP_STRING_FUNC]);
+
+    COLOR_PRINT(DarkMagenta, "called from %s(%ld) %s\n", record->strings[DUMP_STRING_CALL_FILE], header->call_line,
+                                                         record->strings[DUMP_STRING_CALL_FUNC]);
+
+    fprintf(Global_logs_pointer, "{\n");
+
+    if (header->flags & DUMP_HAS_CANARY)
+    {
+        fprintf(Global_logs_pointer, "\tleft_canary = ");
+
+        print_canary(header->canaries[DUMP_LEFT_CANARY_STACK], header->reference_canaries[DUMP_LEFT_CANARY_STACK]);
+    }
+
+    fprintf(Global_logs_pointer,  "\n\tsize = ");
+    COLOR_PRINT(Orange, "%ld\n", header->size);
+
+    fprintf(Global_logs_pointer, "\tcapacity = ");
+    COLOR_PRINT(Crimson, "%ld\n", header->capacity);
+
+    if (header->flags & DUMP_HAS_HASH)
+    {
+        fprintf(Global_logs_pointer, "\tstack_hash = ");
+        COLOR_PRINT(Green, "%u\n", header->stack_hash);
+
+        fprintf(Global_logs_pointer, "\tdata_hash = ");
+        COLOR_PRINT(Green, "%u\n", header->data_hash);
+    }
+
+    fprintf(Global_logs_pointer, "\tdata");
+    COLOR_PRINT(DarkViolet, "[%p]\n", get_address(header->data_address));
+
+    if (header->flags & DUMP_HAS_CANARY)
+    {
+        fprintf(Global_logs_pointer, "\tright_canary = ");
+
+        print_canary(header->canaries[DUMP_RIGHT_CANARY_STACK], header->reference_canaries[DUMP_RIGHT_CANARY_STACK]);
+    }
+
+    fprintf(Global_logs_pointer, "\n\t{\n");
+
+    if (header->flags & DUMP_HAS_CANARY)
+    {
+        fprintf(Global_logs_pointer, "\t\t [left_canary] = ");
+
+        print_canary(header->canaries[DUMP_LEFT_CANARY_ARRAY], header->reference_canaries[DUMP_LEFT_CANARY_ARRAY]);
+
+        COLOR_PRINT(DarkViolet, "[%p]\n", get_address(header->left_canary_array_address));
+    }
+}
+
+void print_canary(int64_t canary, int64_t reference_value_canary)
+{
+    if(canary != reference_value_canary)
+        COLOR_PRINT(Red, "%ld", canary);
+
+    else
+        COLOR_PRINT(Green, "%ld", canary);
+
+    fprintf(Global_logs_pointer,"(reference_value =");
+
+    COLOR_PRINT(Green, "%ld", reference_value_canary);
+
+    fprintf(Global_logs_pointer,")");
+}
+
+void print_element(const dump_record *record, ssize_t index)
+{
+    MYASSERT(record != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    void *address = get_address(record->header->data_address + (uint64_t) index * sizeof(TYPE_ELEMENT_STACK));
+
+    if (is_poison(record, index))
+    {
+        fprintf(Global_logs_pointer, "\t\t [%ld] = " FORMAT_SPECIFIERS_STACK, index, (record->data)[index]);
+
+        COLOR_PRINT(Maroon, "(POISON)%s", "");
+
+        COLOR_PRINT(DarkViolet, "[%p]\n", address);
+    }
+
+    else
+    {
+        fprintf(Global_logs_pointer, "\t\t*[%ld] = " FORMAT_SPECIFIERS_STACK, index, (record->data)[index]);
+
+        COLOR_PRINT(DarkViolet, "[%p]\n", address);
+    }
+}
+
+void diff_records(const dump_record *old_record, const dump_record *new_record, const render_options *options)
+{
+    MYASSERT(old_record != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(new_record != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(options    != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    const stack_dump_header *old_header = old_record->header;
+    const stack_dump_header *new_header = new_record->header;
+
+    COLOR_PRINT(MediumBlue, "stack[%p] -> ", get_address(old_header->stack_address));
+    COLOR_PRINT(MediumBlue, "stack[%p]\n{\n", get_address(new_header->stack_address));
+
+    diff_field("size",       old_header->size,       new_header->size);
+    diff_field("capacity",   old_header->capacity,   new_header->capacity);
+    diff_field("error_code", old_header->error_code, new_header->error_code);
+    diff_field("stack_hash", old_header->stack_hash, new_header->stack_hash);
+    diff_field("data_hash",  old_header->data_hash,  new_header->data_hash);
+
+    const char *CANARY_NAMES[DUMP_CANARIES_COUNT] = {"left_canary", "right_canary", "[left_canary]", "[right_canary]"};
+
+    for (int index = 0; index < DUMP_CANARIES_COUNT; index++)
+        diff_field(CANARY_NAMES[index], old_header->canaries[index], new_header->canaries[index]);
+
+    fprintf(Global_logs_pointer, "\t{\n");
+
+    const dump_record *longer_record = (old_header->capacity >= new_header->capacity) ? old_record : new_record;
+
+    ssize_t from = 0;
+    ssize_t to   = 0;
+    ssize_t differences = 0;
+
+    get_range(longer_record, options, &from, &to);
+
+    for (ssize_t index = from; index < to; index++)
+    {
+        bool in_old = (index < old_header->capacity);
+        bool in_new = (index < new_header->capacity);
+
+        bool old_poison = in_old && is_poison(old_record, index);
+        bool new_poison = in_new && is_poison(new_record, index);
+
+        if (in_old && in_new && old_poison == new_poison && (old_record->data)[index] == (new_record->data)[index])
+            continue;
+
+        differences++;
+
+        fprintf(Global_logs_pointer, "\t\t [%ld] = ", index);
+
+        if (in_old)
+            COLOR_PRINT(Maroon, FORMAT_SPECIFIERS_STACK "%s", (old_record->data)[index], old_poison ? "(POISON)" : "");
+        else
+            COLOR_PRINT(Maroon, "%s", "(none)");
+
+        fprintf(Global_logs_pointer, " -> ");
+
+        if (in_new)
+            COLOR_PRINT(Green, FORMAT_SPECIFIERS_STACK "%s\n", (new_record->data)[index], new_poison ? "(POISON)" : "");
+        else
+            COLOR_PRINT(Green, "%s\n", "(none)");
+    }
+
+    fprintf(Global_logs_pointer, "\t}\n\tdifferent elements = ");
+    COLOR_PRINT(Orange, "%ld\n", differences);
+
+    fprintf(Global_logs_pointer, "}\n\n");
+}
+
+void diff_field(const char *name, int64_t old_value, int64_t new_value)
+{
+    MYASSERT(name != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    if (old_value == new_value)
+        return;
+
+    fprintf(Global_logs_pointer, "\t%s = ", name);
+
+    COLOR_PRINT(Maroon, "%ld", old_value);
+
+    fprintf(Global_logs_pointer, " -> ");
+
+    COLOR_PRINT(Green, "%ld\n", new_value);
+}
+
+bool is_poison(const dump_record *record, ssize_t index)
+{
+    MYASSERT(record != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    if (record->bitmap != NULL)
+        return (record->bitmap[index / 8] >> (index % 8)) & 1;
+
+    return (record->data)[index] == POISON;
+}
+
+void get_range(const dump_record *record, const render_options *options, ssize_t *from, ssize_t *to)
+{
+    MYASSERT(record  != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(options != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(from    != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(to      != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    ssize_t capacity = record->header->capacity;
+
+    *from = (options->range_from > 0) ? options->range_from : 0;
+    *to   = (options->range_to >= 0 && options->range_to < capacity) ? options->range_to : capacity;
+
+    if (*from > *to)
+        *from = *to;
+}
+
+void *get_address(uint64_t address)
+{
+    return (void *) address;
+}
@@ -0,0 +1,227 @@
+#include "hash_pool.h"
+#include "myassert.h"
+#include <pthread.h>
+
+const ssize_t HASH_BATCH_CHUNKS = 64;
+
+struct hash_job {
+    const char                     *array;
+    ssize_t                         size;
+    uint32_t                        seed;
+    uint32_t                       *hashes;
+    ssize_t                         chunks_count;
+    ssize_t                         next_chunk;
+};
+
+struct hash_pool {
+    pthread_t                       workers[HASH_MAX_THREADS];
+    ssize_t                         workers_count;
+
+    pthread_mutex_t                 lock;
+    pthread_cond_t                  job_posted;
+    pthread_cond_t                  job_finished;
+    pthread_mutex_t                 submit_lock;
+
+    hash_job                       *job;
+    uint64_t                        generation;
+    ssize_t                         active_workers;
+    bool                            is_stopping;
+};
+
+static hash_pool Pool = {
+    {},
+    0,
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    NULL,
+    0,
+    0,
+    false
+};
+
+static pthread_mutex_t Configure_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void  stop_workers();
+static void *worker_routine(void *argument);
+static void  run_job(hash_job *job);
+static void  run_chunks(hash_job *job);
+
+ssize_t hash_pool_set_threads(ssize_t threads_count)
+{
+    MYASSERT(threads_count >= 0, NEGATIVE_VALUE_SIZE_T, return SIZE_LESS_THAN_ZERO);
+
+    if (threads_count > HASH_MAX_THREADS)
+        threads_count = HASH_MAX_THREADS;
+
+    pthread_mutex_lock(&Configure_lock);
+    pthread_mutex_lock(&Pool.submit_lock);
+
+    stop_workers();
+
+    // The calling thread hashes too, so it counts as one of the threads. Workers start from the current
+    // generation, so a job posted before a new worker gets scheduled is still picked up by it.
+    for (ssize_t index = 0; index + 1 < threads_count; index++)
+    {
+        if (pthread_create(Pool.workers + index, NULL, worker_routine, (void *) Pool.generation) != 0)
+            break;
+
+        pthread_mutex_lock(&Pool.lock);
+
+        Pool.workers_count++;
+
+        pthread_mutex_unlock(&Pool.lock);
+    }
+
+    pthread_mutex_unlock(&Pool.submit_lock);
+    pthread_mutex_unlock(&Configure_lock);
+
+    return NO_ERROR;
+}
+
+ssize_t hash_pool_get_threads()
+{
+    pthread_mutex_lock(&Pool.lock);
+
+    ssize_t threads_count = Pool.workers_count + 1;
+
+    pthread_mutex_unlock(&Pool.lock);
+
+    return threads_count;
+}
+
+// The result depends only on the bytes and the seed: chunk boundaries are fixed, so any number of threads agrees.
+// Chunk hashes go through a local batch and are folded in order, so no buffer is allocated however big the array is.
+uint32_t hash_chunked(const void *array, ssize_t size, uint32_t seed)
+{
+    MYASSERT(array != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+    MYASSERT(size  >= 0,    NEGATIVE_VALUE_SIZE_T,       return 0);
+
+    uint32_t batch_hashes[HASH_BATCH_CHUNKS] = {};
+
+    ssize_t  chunks_count = (size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+    uint32_t hash         = seed;
+
+    for (ssize_t first_chunk = 0; first_chunk < chunks_count; first_chunk += HASH_BATCH_CHUNKS)
+    {
+        ssize_t begin = first_chunk * HASH_CHUNK_SIZE;
+
+        hash_job job = {};
+
+        job.array        = (const char *) array + begin;
+        job.size         = (size - begin < HASH_BATCH_CHUNKS * HASH_CHUNK_SIZE) ? size - begin : HASH_BATCH_CHUNKS * HASH_CHUNK_SIZE;
+        job.seed         = seed + (uint32_t) first_chunk;
+        job.chunks_count = (job.size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+        job.next_chunk   = 0;
+        job.hashes       = batch_hashes;
+
+        run_job(&job);
+
+        hash = hash_buffer_update(batch_hashes, job.chunks_count * (ssize_t) sizeof(uint32_t), hash);
+    }
+
+    return hash_buffer_finish(hash);
+}
+
+void run_job(hash_job *job)
+{
+    MYASSERT(job != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    if (job->chunks_count > 1 && pthread_mutex_trylock(&Pool.submit_lock) == 0)
+    {
+        pthread_mutex_lock(&Pool.lock);
+
+        Pool.job            = job;
+        Pool.active_workers = Pool.workers_count;
+        Pool.generation++;
+
+        pthread_cond_broadcast(&Pool.job_posted);
+        pthread_mutex_unlock(&Pool.lock);
+
+        run_chunks(job);
+
+        pthread_mutex_lock(&Pool.lock);
+
+        while (Pool.active_workers > 0)
+            pthread_cond_wait(&Pool.job_finished, &Pool.lock);
+
+        Pool.job = NULL;
+
+        pthread_mutex_unlock(&Pool.lock);
+        pthread_mutex_unlock(&Pool.submit_lock);
+    }
+
+    else
+        run_chunks(job);
+}
+
+void stop_workers()
+{
+    pthread_mutex_lock(&Pool.lock);
+
+    Pool.is_stopping = true;
+
+    pthread_cond_broadcast(&Pool.job_posted);
+    pthread_mutex_unlock(&Pool.lock);
+
+    for (ssize_t index = 0; index < Pool.workers_count; index++)
+        pthread_join(Pool.workers[index], NULL);
+
+    pthread_mutex_lock(&Pool.lock);
+
+    Pool.workers_count = 0;
+    Pool.is_stopping   = false;
+
+    pthread_mutex_unlock(&Pool.lock);
+}
+
+void *worker_routine(void *argument)
+{
+    uint64_t seen_generation = (uintptr_t) argument;
+
+    pthread_mutex_lock(&Pool.lock);
+
+    while (true)
+    {
+        while (!Pool.is_stopping && Pool.generation == seen_generation)
+            pthread_cond_wait(&Pool.job_posted, &Pool.lock);
+
+        if (Pool.is_stopping)
+            break;
+
+        seen_generation = Pool.generation;
+        hash_job *job   = Pool.job;
+
+        pthread_mutex_unlock(&Pool.lock);
+
+        run_chunks(job);
+
+        pthread_mutex_lock(&Pool.lock);
+
+        if (--Pool.active_workers == 0)
+            pthread_cond_signal(&Pool.job_finished);
+    }
+
+    pthread_mutex_unlock(&Pool.lock);
+
+    return NULL;
+}
+
+void run_chunks(hash_job *job)
+{
+    MYASSERT(job != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    while (true)
+    {
+        ssize_t chunk = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+
+        if (chunk >= job->chunks_count)
+            break;
+
+        ssize_t begin  = chunk * HASH_CHUNK_SIZE;
+        ssize_t length = (job->size - begin < HASH_CHUNK_SIZE) ? job->size - begin : HASH_CHUNK_SIZE;
+
+        job->hashes[chunk] = hash_buffer(job->array + begin, length, job->seed + (uint32_t) chunk);
+    }
+}
@@ -0,0 +1,348 @@
+#include "numa_stack.h"
+#include "myassert.h"
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+numa_policy Global_numa_policy = NUMA_POLICY_DEFAULT;
+int         Global_numa_node   = 0;
+
+static numa_topology    Topology        = {};
+static bool             Topology_loaded = false;
+static pthread_mutex_t  Topology_lock   = PTHREAD_MUTEX_INITIALIZER;
+static numa_statistics  Statistics      = {};
+
+static __thread int     Thread_node     = NUMA_NODE_ANY;
+
+static const numa_topology *lock_topology();
+static void load_system_topology(numa_topology *topology);
+static bool parse_cpulist(const char *file_name, numa_topology *topology, int node);
+
+// The topology is copied out: numa_set_simulated_topology may replace it at any time.
+ssize_t numa_get_topology(numa_topology *topology)
+{
+    MYASSERT(topology != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    *topology = *lock_topology();
+
+    pthread_mutex_unlock(&Topology_lock);
+
+    return NO_ERROR;
+}
+
+// Returns the loaded topology with Topology_lock held, the caller unlocks it.
+const numa_topology *lock_topology()
+{
+    pthread_mutex_lock(&Topology_lock);
+
+    if (!Topology_loaded)
+    {
+        load_system_topology(&Topology);
+        Topology_loaded = true;
+    }
+
+    return &Topology;
+}
+
+ssize_t numa_set_simulated_topology(const int *cpu_to_node, ssize_t cpus_count)
+{
+    MYASSERT(cpu_to_node != NULL,                         NULL_POINTER_PASSED_TO_FUNC,  return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(cpus_count > 0 && cpus_count <= NUMA_MAX_CPUS, GOING_BEYOUND_BOUNDARY_ARRAY, return SIZE_MORE_THAN_CAPACITY);
+
+    numa_topology topology = {};
+
+    topology.cpus_count   = cpus_count;
+    topology.is_simulated = true;
+
+    for (ssize_t cpu = 0; cpu < cpus_count; cpu++)
+    {
+        if (cpu_to_node[cpu] < 0 || cpu_to_node[cpu] >= NUMA_MAX_NODES)
+            return SIZE_MORE_THAN_CAPACITY;
+
+        topology.cpu_to_node[cpu] = cpu_to_node[cpu];
+
+        if (cpu_to_node[cpu] + 1 > topology.nodes_count)
+            topology.nodes_count = cpu_to_node[cpu] + 1;
+    }
+
+    pthread_mutex_lock(&Topology_lock);
+
+    Topology        = topology;
+    Topology_loaded = true;
+
+    pthread_mutex_unlock(&Topology_lock);
+
+    return NO_ERROR;
+}
+
+ssize_t numa_reset_topology()
+{
+    pthread_mutex_lock(&Topology_lock);
+
+    Topology_loaded = false;
+
+    pthread_mutex_unlock(&Topology_lock);
+
+    return NO_ERROR;
+}
+
+ssize_t numa_simulate_thread_node(int node)
+{
+    MYASSERT(node < NUMA_MAX_NODES, GOING_BEYOUND_BOUNDARY_ARRAY, return SIZE_MORE_THAN_CAPACITY);
+
+    Thread_node = (node >= 0) ? node : NUMA_NODE_ANY;
+
+    return NO_ERROR;
+}
+
+int numa_current_node()
+{
+    if (Thread_node != NUMA_NODE_ANY)
+        return Thread_node;
+
+    int cpu  = sched_getcpu();
+    int node = 0;
+
+    const numa_topology *topology = lock_topology();
+
+    if (cpu >= 0 && cpu < topology->cpus_count)
+        node = topology->cpu_to_node[cpu];
+
+    pthread_mutex_unlock(&Topology_lock);
+
+    return node;
+}
+
+int numa_choose_node()
+{
+    switch (Global_numa_policy)
+    {
+        case NUMA_POLICY_FIRST_TOUCH:
+            return numa_current_node();
+
+        case NUMA_POLICY_EXPLICIT:
+            return Global_numa_node;
+
+        case NUMA_POLICY_DEFAULT:
+        default:
+            return NUMA_NODE_ANY;
+    }
+}
+
+bool numa_bind_memory(void *memory, size_t size, int node)
+{
+    MYASSERT(memory != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    if (node < 0 || node >= NUMA_MAX_NODES)
+        return false;
+
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+
+    uintptr_t begin = ((uintptr_t) memory + page_size - 1) & ~(page_size - 1);
+    uintptr_t end   = ((uintptr_t) memory + size)          & ~(page_size - 1);
+
+    // Partial pages at the edges are shared with other allocations and are left where they are.
+    if (begin >= end)
+        return true;
+
+    __atomic_add_fetch(&Statistics.bind_calls,  1,                       __ATOMIC_RELAXED);
+    __atomic_add_fetch(&Statistics.bound_bytes, (ssize_t) (end - begin), __ATOMIC_RELAXED);
+
+    bool is_simulated = lock_topology()->is_simulated;
+
+    pthread_mutex_unlock(&Topology_lock);
+
+    if (is_simulated)
+        return true;
+
+    unsigned long node_mask[NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = {};
+
+    node_mask[(size_t) node / (8 * sizeof(unsigned long))] = 1UL << ((size_t) node % (8 * sizeof(unsigned long)));
+
+    if (syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED, node_mask, NUMA_MAX_NODES + 1, MPOL_MF_MOVE) != 0)
+    {
+        __atomic_add_fetch(&Statistics.failed_binds, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    return true;
+}
+
+numa_statistics numa_get_statistics()
+{
+    numa_statistics statistics = {};
+
+    statistics.bind_calls   = __atomic_load_n(&Statistics.bind_calls,   __ATOMIC_RELAXED);
+    statistics.bound_bytes  = __atomic_load_n(&Statistics.bound_bytes,  __ATOMIC_RELAXED);
+    statistics.failed_binds = __atomic_load_n(&Statistics.failed_binds, __ATOMIC_RELAXED);
+
+    return statistics;
+}
+
+ssize_t numa_pool_constructor(numa_stack_pool *pool)
+{
+    MYASSERT(pool != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    for (ssize_t node = 0; node < NUMA_MAX_NODES; node++)
+    {
+        pool->stacks[node]     = NULL;
+        pool->sizes[node]      = 0;
+        pool->capacities[node] = 0;
+
+        pthread_mutex_init(pool->locks + node, NULL);
+    }
+
+    return NO_ERROR;
+}
+
+ssize_t numa_pool_destructor(numa_stack_pool *pool)
+{
+    MYASSERT(pool != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = NO_ERROR;
+
+    for (ssize_t node = 0; node < NUMA_MAX_NODES; node++)
+    {
+        for (ssize_t index = 0; index < pool->sizes[node]; index++)
+            error_code |= stack_destructor(pool->stacks[node][index]);
+
+        free(pool->stacks[node]);
+
+        pool->stacks[node]     = NULL;
+        pool->sizes[node]      = 0;
+        pool->capacities[node] = 0;
+
+        pthread_mutex_destroy(pool->locks + node);
+    }
+
+    return error_code;
+}
+
+stack *numa_pool_get(numa_stack_pool *pool)
+{
+    MYASSERT(pool != NULL, NULL_POINTER_PASSED_TO_FUNC, return NULL);
+
+    int node = numa_current_node();
+
+    if (node < 0 || node >= NUMA_MAX_NODES)
+        node = 0;
+
+    stack *stk = NULL;
+
+    pthread_mutex_lock(pool->locks + node);
+
+    if (pool->sizes[node] > 0)
+        stk = pool->stacks[node][--pool->sizes[node]];
+
+    pthread_mutex_unlock(pool->locks + node);
+
+    if (stk != NULL)
+        return stk;
+
+    stk = get_pointer_stack();
+    MYASSERT(stk != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return NULL);
+
+    STACK_CONSTRUCTOR_ON_NODE(stk, node);
+
+    return stk;
+}
+
+ssize_t numa_pool_put(numa_stack_pool *pool, stack *stk)
+{
+    MYASSERT(pool != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = stack_rollback(stk, 0);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    int node = (stk->numa_node >= 0 && stk->numa_node < NUMA_MAX_NODES) ? stk->numa_node : 0;
+
+    pthread_mutex_lock(pool->locks + node);
+
+    if (pool->sizes[node] >= pool->capacities[node])
+    {
+        ssize_t capacity   = (pool->capacities[node] > 0) ? pool->capacities[node] * CAPACITY_MULTIPLIER : INITIAL_CAPACITY_VALUE;
+        stack **new_stacks = (stack **) realloc(pool->stacks[node], (size_t) capacity * sizeof(stack *));
+
+        if (new_stacks == NULL)
+        {
+            pthread_mutex_unlock(pool->locks + node);
+
+            return stack_destructor(stk);
+        }
+
+        pool->stacks[node]     = new_stacks;
+        pool->capacities[node] = capacity;
+    }
+
+    pool->stacks[node][pool->sizes[node]++] = stk;
+
+    pthread_mutex_unlock(pool->locks + node);
+
+    return NO_ERROR;
+}
+
+void load_system_topology(numa_topology *topology)
+{
+    MYASSERT(topology != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    char file_name[64] = {};
+
+    *topology = {};
+
+    for (int node = 0; node < NUMA_MAX_NODES; node++)
+    {
+        snprintf(file_name, sizeof(file_name), "/sys/devices/system/node/node%d/cpulist", node);
+
+        if (parse_cpulist(file_name, topology, node))
+            topology->nodes_count = node + 1;
+    }
+
+    if (topology->nodes_count == 0)
+        topology->nodes_count = 1;
+
+    if (topology->cpus_count == 0)
+        topology->cpus_count = NUMA_MAX_CPUS;
+}
+
+bool parse_cpulist(const char *file_name, numa_topology *topology, int node)
+{
+    MYASSERT(file_name != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+    MYASSERT(topology  != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    FILE *file_pointer = fopen(file_name, "r");
+
+    if (file_pointer == NULL)
+        return false;
+
+    long first = 0;
+    long last  = 0;
+
+    while (fscanf(file_pointer, "%ld", &first) == 1)
+    {
+        last = first;
+
+        int separator = fgetc(file_pointer);
+
+        if (separator == '-' && fscanf(file_pointer, "%ld", &last) == 1)
+            separator = fgetc(file_pointer);
+
+        for (long cpu = first; cpu <= last && cpu < NUMA_MAX_CPUS; cpu++)
+        {
+            topology->cpu_to_node[cpu] = node;
+
+            if (cpu + 1 > topology->cpus_count)
+                topology->cpus_count = cpu + 1;
+        }
+
+        if (separator != ',')
+            break;
+    }
+
+    fclose(file_pointer);
+
+    return true;
+}
@@ -0,0 +1,211 @@
+#include "persistent_stack.h"
+#include "myassert.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+// One pool serves every thread: a node freed by one owner may be handed out to another, so all of it is locked.
+static pthread_mutex_t   Pool_lock       = PTHREAD_MUTEX_INITIALIZER;
+static persistent_chunk *Pool_chunks     = NULL;
+static persistent_node  *Pool_free_nodes = NULL;
+static ssize_t           Pool_nodes_used = 0;
+
+static persistent_node *allocate_node();
+static ssize_t add_pool_chunk();
+static void release_node(persistent_node *node);
+static void retain_node(persistent_node *node);
+
+persistent_stack persistent_stack_empty()
+{
+    persistent_stack stk = {};
+
+    stk.top  = NULL;
+    stk.size = 0;
+
+    return stk;
+}
+
+persistent_stack persistent_stack_fork(const persistent_stack *stk)
+{
+    MYASSERT(stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return persistent_stack_empty());
+
+    retain_node(stk->top);
+
+    return *stk;
+}
+
+ssize_t persistent_stack_release(persistent_stack *stk)
+{
+    MYASSERT(stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    release_node(stk->top);
+
+    stk->top  = NULL;
+    stk->size = 0;
+
+    return NO_ERROR;
+}
+
+ssize_t persistent_push(const persistent_stack *stk, TYPE_ELEMENT_STACK value, persistent_stack *new_version)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(new_version != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    persistent_node *node = allocate_node();
+
+    if (node == NULL)
+        return POINTER_TO_STACK_DATA_IS_NULL;
+
+    node->value     = value;
+    node->ref_count = 1;
+    node->next      = stk->top;
+
+    retain_node(stk->top);
+
+    new_version->top  = node;
+    new_version->size = stk->size + 1;
+
+    return NO_ERROR;
+}
+
+ssize_t persistent_pop(const persistent_stack *stk, TYPE_ELEMENT_STACK *return_value, persistent_stack *new_version)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(new_version  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (stk->size == 0)
+        return SIZE_NULL_IN_POP;
+
+    persistent_node *top = stk->top;
+
+    *return_value = top->value;
+
+    retain_node(top->next);
+
+    new_version->top  = top->next;
+    new_version->size = stk->size - 1;
+
+    return NO_ERROR;
+}
+
+ssize_t persistent_top(const persistent_stack *stk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (stk->size == 0)
+        return SIZE_NULL_IN_POP;
+
+    *return_value = stk->top->value;
+
+    return NO_ERROR;
+}
+
+ssize_t persistent_pool_destructor()
+{
+    pthread_mutex_lock(&Pool_lock);
+
+    if (Pool_nodes_used != 0)
+    {
+        pthread_mutex_unlock(&Pool_lock);
+        return POOL_STILL_IN_USE;
+    }
+
+    while (Pool_chunks != NULL)
+    {
+        persistent_chunk *next = Pool_chunks->next;
+
+        free(Pool_chunks);
+
+        Pool_chunks = next;
+    }
+
+    Pool_free_nodes = NULL;
+    Pool_nodes_used = 0;
+
+    pthread_mutex_unlock(&Pool_lock);
+
+    return NO_ERROR;
+}
+
+persistent_node *allocate_node()
+{
+    pthread_mutex_lock(&Pool_lock);
+
+    if (Pool_free_nodes == NULL && add_pool_chunk() != NO_ERROR)
+    {
+        pthread_mutex_unlock(&Pool_lock);
+        return NULL;
+    }
+
+    persistent_node *node = Pool_free_nodes;
+    Pool_free_nodes = node->next;
+
+    Pool_nodes_used++;
+
+    pthread_mutex_unlock(&Pool_lock);
+
+    return node;
+}
+
+ssize_t add_pool_chunk()
+{
+    persistent_chunk *chunk = (persistent_chunk *) calloc(1, sizeof(persistent_chunk));
+    MYASSERT(chunk != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    if (chunk == NULL)
+        return POINTER_TO_STACK_DATA_IS_NULL;
+
+    for (ssize_t index = PERSISTENT_NODES_IN_CHUNK - 1; index >= 0; index--)
+    {
+        chunk->nodes[index].next = Pool_free_nodes;
+        Pool_free_nodes = chunk->nodes + index;
+    }
+
+    chunk->next = Pool_chunks;
+    Pool_chunks = chunk;
+
+    return NO_ERROR;
+}
+
+// Versions in different threads may share a tail, so the counts change atomically. The nodes that drop to zero
+// are gathered first and go back to the pool under one lock.
+void release_node(persistent_node *node)
+{
+    persistent_node *freed       = NULL;
+    persistent_node *freed_last  = NULL;
+    ssize_t          freed_count = 0;
+
+    while (node != NULL && __atomic_sub_fetch(&node->ref_count, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        persistent_node *next = node->next;
+
+        if (freed_last == NULL)
+            freed_last = node;
+
+        node->next = freed;
+        freed = node;
+
+        freed_count++;
+
+        node = next;
+    }
+
+    if (freed == NULL)
+        return;
+
+    pthread_mutex_lock(&Pool_lock);
+
+    freed_last->next = Pool_free_nodes;
+    Pool_free_nodes  = freed;
+
+    Pool_nodes_used -= freed_count;
+
+    pthread_mutex_unlock(&Pool_lock);
+}
+
+void retain_node(persistent_node *node)
+{
+    if (node != NULL)
+        __atomic_add_fetch(&node->ref_count, 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,446 @@
+#include "shm_stack.h"
+#include "myassert.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+const uint64_t VALUE_LEFT_CANARY_SEGMENT  = 0xDEDDADDEDDAD;
+const uint64_t VALUE_RIGHT_CANARY_SEGMENT = 0xDEDBEDDEDBED;
+const uint64_t VALUE_LEFT_CANARY_DATA     = 0xDEDDEDDEDDED;
+const uint64_t VALUE_RIGHT_CANARY_DATA    = 0xDEDBADDEDBAD;
+
+static ssize_t map_segment(shm_stack *stk, int descriptor, size_t mapping_size);
+static ssize_t check_segment(shm_stack_header *header, size_t mapping_size);
+static ssize_t check_layout(shm_stack_header *header, size_t mapping_size);
+
+static bool    init_segment_lock(pthread_mutex_t *lock);
+static ssize_t lock_segment(shm_stack *stk);
+static void    unlock_segment(shm_stack *stk);
+static ssize_t recover_segment(shm_stack *stk);
+
+static TYPE_ELEMENT_STACK *get_shm_data(shm_stack_header *header);
+static uint64_t *get_shm_left_canary(shm_stack_header *header);
+static uint64_t *get_shm_right_canary(shm_stack_header *header);
+
+IF_ON_HASH_PROTECT
+(
+    static void update_segment_hash(shm_stack_header *header);
+    static uint32_t calculate_state_hash(shm_stack_header *header);
+    static uint32_t calculate_data_hash(shm_stack_header *header);
+)
+
+ssize_t shm_stack_constructor(shm_stack *stk, const char *name, ssize_t capacity)
+{
+    MYASSERT(stk  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(name != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+    MYASSERT(capacity > 0, NEGATIVE_VALUE_SIZE_T,       return CAPACITY_LESS_THAN_ZERO);
+
+    if (strlen(name) >= SHM_MAX_NAME_LENGTH)
+        return BAD_SHARED_SEGMENT;
+
+    int64_t data_offset  = (int64_t) ((sizeof(shm_stack_header) + 2 * sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+    int64_t data_length  = (int64_t) (((size_t) capacity * sizeof(TYPE_ELEMENT_STACK) + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+    int64_t segment_size = data_offset + data_length + (int64_t) sizeof(uint64_t);
+
+    int descriptor = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (descriptor < 0)
+        return BAD_SHARED_SEGMENT;
+
+    if (ftruncate(descriptor, segment_size) != 0)
+    {
+        close(descriptor);
+        shm_unlink(name);
+
+        return BAD_SHARED_SEGMENT;
+    }
+
+    ssize_t error_code = map_segment(stk, descriptor, (size_t) segment_size);
+
+    if (error_code != NO_ERROR)
+    {
+        shm_unlink(name);
+        return error_code;
+    }
+
+    strcpy(stk->name, name);
+
+    shm_stack_header *header = stk->header;
+
+    header->state.magic        = SHM_STACK_MAGIC;
+    header->state.version      = SHM_STACK_VERSION;
+    header->state.element_size = sizeof(TYPE_ELEMENT_STACK);
+    header->state.capacity     = capacity;
+    header->state.size         = 0;
+    header->state.data_offset  = data_offset;
+    header->state.segment_size = segment_size;
+    header->recoveries         = 0;
+
+    *get_shm_left_canary(header)  = VALUE_LEFT_CANARY_DATA;
+    *get_shm_right_canary(header) = VALUE_RIGHT_CANARY_DATA;
+
+    if (!init_segment_lock(&header->lock))
+    {
+        shm_stack_destructor(stk);
+        return BAD_SHARED_SEGMENT;
+    }
+
+    IF_ON_HASH_PROTECT(update_segment_hash(header));
+
+    header->right_canary = VALUE_RIGHT_CANARY_SEGMENT;
+
+    // Peers treat the segment as ready once the left canary is in place.
+    __atomic_store_n(&header->left_canary, VALUE_LEFT_CANARY_SEGMENT, __ATOMIC_RELEASE);
+
+    return NO_ERROR;
+}
+
+ssize_t shm_stack_destructor(shm_stack *stk)
+{
+    MYASSERT(stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    char name[SHM_MAX_NAME_LENGTH] = {};
+
+    strcpy(name, stk->name);
+
+    ssize_t error_code = shm_stack_detach(stk);
+
+    if (name[0] != '\0' && shm_unlink(name) != 0)
+        error_code |= BAD_SHARED_SEGMENT;
+
+    return error_code;
+}
+
+ssize_t shm_stack_attach(shm_stack *stk, const char *name)
+{
+    MYASSERT(stk  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(name != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    if (strlen(name) >= SHM_MAX_NAME_LENGTH)
+        return BAD_SHARED_SEGMENT;
+
+    int descriptor = shm_open(name, O_RDWR, 0600);
+
+    if (descriptor < 0)
+        return BAD_SHARED_SEGMENT;
+
+    struct stat segment_stat = {};
+
+    if (fstat(descriptor, &segment_stat) != 0 || (size_t) segment_stat.st_size < sizeof(shm_stack_header))
+    {
+        close(descriptor);
+        return BAD_SHARED_SEGMENT;
+    }
+
+    ssize_t error_code = map_segment(stk, descriptor, (size_t) segment_stat.st_size);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    if (__atomic_load_n(&stk->header->left_canary, __ATOMIC_ACQUIRE) != VALUE_LEFT_CANARY_SEGMENT ||
+        check_layout(stk->header, stk->mapping_size) != NO_ERROR)
+    {
+        shm_stack_detach(stk);
+        return BAD_SHARED_SEGMENT;
+    }
+
+    strcpy(stk->name, name);
+
+    return NO_ERROR;
+}
+
+ssize_t shm_stack_detach(shm_stack *stk)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = (munmap(stk->header, stk->mapping_size) == 0) ? NO_ERROR : BAD_SHARED_SEGMENT;
+
+    stk->header       = NULL;
+    stk->mapping_size = 0;
+    stk->name[0]      = '\0';
+
+    return error_code;
+}
+
+ssize_t shm_push(shm_stack *stk, TYPE_ELEMENT_STACK value)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = lock_segment(stk);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    shm_stack_header *header = stk->header;
+
+    if (header->state.size >= header->state.capacity)
+    {
+        unlock_segment(stk);
+        return STACK_IS_FULL;
+    }
+
+    // The element lands above size first, so a peer dying between the two stores leaves the old stack intact.
+    get_shm_data(header)[header->state.size] = value;
+
+    header->state.size++;
+
+    IF_ON_HASH_PROTECT(update_segment_hash(header));
+
+    unlock_segment(stk);
+
+    return NO_ERROR;
+}
+
+ssize_t shm_pop(shm_stack *stk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header  != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = lock_segment(stk);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    shm_stack_header *header = stk->header;
+
+    if (header->state.size == 0)
+    {
+        unlock_segment(stk);
+        return SIZE_NULL_IN_POP;
+    }
+
+    *return_value = get_shm_data(header)[header->state.size - 1];
+
+    header->state.size--;
+
+    IF_ON_HASH_PROTECT(update_segment_hash(header));
+
+    unlock_segment(stk);
+
+    return NO_ERROR;
+}
+
+ssize_t shm_stack_size(shm_stack *stk, ssize_t *size)
+{
+    MYASSERT(size        != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = lock_segment(stk);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    *size = stk->header->state.size;
+
+    unlock_segment(stk);
+
+    return NO_ERROR;
+}
+
+ssize_t verify_shm_stack(shm_stack *stk)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = lock_segment(stk);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    unlock_segment(stk);
+
+    return NO_ERROR;
+}
+
+ssize_t map_segment(shm_stack *stk, int descriptor, size_t mapping_size)
+{
+    MYASSERT(stk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    void *mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+    close(descriptor);
+
+    if (mapping == MAP_FAILED)
+        return BAD_SHARED_SEGMENT;
+
+    stk->header       = (shm_stack_header *) mapping;
+    stk->mapping_size = mapping_size;
+    stk->error_code   = NO_ERROR;
+
+    return NO_ERROR;
+}
+
+ssize_t check_segment(shm_stack_header *header, size_t mapping_size)
+{
+    MYASSERT(header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = check_layout(header, mapping_size);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    IF_ON_HASH_PROTECT
+    (
+        if (header->state_hash != calculate_state_hash(header))
+            error_code |= STACK_HASH_CHANGED;
+
+        if (header->data_hash != calculate_data_hash(header))
+            error_code |= DATA_HASH_CHANGED;
+    )
+
+    return error_code;
+}
+
+ssize_t check_layout(shm_stack_header *header, size_t mapping_size)
+{
+    MYASSERT(header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    shm_stack_state *state = &header->state;
+
+    if (header->left_canary  != VALUE_LEFT_CANARY_SEGMENT  ||
+        header->right_canary != VALUE_RIGHT_CANARY_SEGMENT ||
+        state->magic         != SHM_STACK_MAGIC            ||
+        state->version       != SHM_STACK_VERSION          ||
+        state->element_size  != sizeof(TYPE_ELEMENT_STACK) ||
+        state->segment_size  != (int64_t) mapping_size)
+        return BAD_SHARED_SEGMENT;
+
+    if (state->capacity < 0)
+        return CAPACITY_LESS_THAN_ZERO;
+
+    if (state->data_offset < (int64_t) (sizeof(shm_stack_header) + sizeof(uint64_t)) ||
+        state->data_offset + state->capacity * state->element_size + (int64_t) sizeof(uint64_t) > state->segment_size)
+        return BAD_SHARED_SEGMENT;
+
+    if (*get_shm_left_canary(header)  != VALUE_LEFT_CANARY_DATA ||
+        *get_shm_right_canary(header) != VALUE_RIGHT_CANARY_DATA)
+        return BAD_SHARED_SEGMENT;
+
+    if (state->size < 0)
+        return SIZE_LESS_THAN_ZERO;
+
+    if (state->size > state->capacity)
+        return SIZE_MORE_THAN_CAPACITY;
+
+    return NO_ERROR;
+}
+
+bool init_segment_lock(pthread_mutex_t *lock)
+{
+    MYASSERT(lock != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    pthread_mutexattr_t attributes = {};
+
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+
+    int status = pthread_mutex_init(lock, &attributes);
+
+    pthread_mutexattr_destroy(&attributes);
+
+    return status == 0;
+}
+
+ssize_t lock_segment(shm_stack *stk)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    int status = pthread_mutex_lock(&stk->header->lock);
+
+    if (status == EOWNERDEAD)
+        stk->error_code = recover_segment(stk);
+
+    else if (status != 0)
+        stk->error_code = BAD_SHARED_SEGMENT;
+
+    else
+        stk->error_code = check_segment(stk->header, stk->mapping_size);
+
+    if (status == 0 || status == EOWNERDEAD)
+    {
+        if (stk->error_code != NO_ERROR)
+            pthread_mutex_unlock(&stk->header->lock);
+    }
+
+    return stk->error_code;
+}
+
+void unlock_segment(shm_stack *stk)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    pthread_mutex_unlock(&stk->header->lock);
+}
+
+// A peer died holding the lock. Every mutation is a single store of size, so a sound layout means
+// the peer stopped between whole operations and only the hashes can be stale. A broken layout
+// leaves the mutex inconsistent, and every later lock fails with BAD_SHARED_SEGMENT.
+ssize_t recover_segment(shm_stack *stk)
+{
+    MYASSERT(stk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->header != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
+    ssize_t error_code = check_layout(stk->header, stk->mapping_size);
+
+    if (error_code != NO_ERROR)
+        return error_code | BAD_SHARED_SEGMENT;
+
+    IF_ON_HASH_PROTECT(update_segment_hash(stk->header));
+
+    stk->header->recoveries++;
+
+    if (pthread_mutex_consistent(&stk->header->lock) != 0)
+        return BAD_SHARED_SEGMENT;
+
+    return NO_ERROR;
+}
+
+TYPE_ELEMENT_STACK *get_shm_data(shm_stack_header *header)
+{
+    return (TYPE_ELEMENT_STACK *) ((char *) header + header->state.data_offset);
+}
+
+uint64_t *get_shm_left_canary(shm_stack_header *header)
+{
+    return (uint64_t *) ((char *) header + header->state.data_offset - sizeof(uint64_t));
+}
+
+uint64_t *get_shm_right_canary(shm_stack_header *header)
+{
+    return (uint64_t *) ((char *) header + header->state.segment_size - sizeof(uint64_t));
+}
+
+IF_ON_HASH_PROTECT
+(
+    void update_segment_hash(shm_stack_header *header)
+    {
+        MYASSERT(header != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+        header->state_hash = calculate_state_hash(header);
+        header->data_hash  = calculate_data_hash(header);
+    }
+
+    uint32_t calculate_state_hash(shm_stack_header *header)
+    {
+        MYASSERT(header != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+
+        return hash_buffer(&header->state, sizeof(header->state), SHM_STACK_MAGIC);
+    }
+
+    uint32_t calculate_data_hash(shm_stack_header *header)
+    {
+        MYASSERT(header != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+
+        return hash_buffer(get_shm_data(header), header->state.size * (ssize_t) sizeof(TYPE_ELEMENT_STACK), SHM_STACK_MAGIC);
+    }
+)
@@ -0,0 +1,446 @@
+#include "spill_stack.h"
+#include "myassert.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+const ssize_t SPILL_WINDOW_SEGMENTS = 3;
+
+static ssize_t spill_bottom(spill_stack *sstk);
+static ssize_t fill_from_spill(spill_stack *sstk);
+
+static ssize_t start_prefetcher(spill_stack *sstk);
+static void    request_prefetch(spill_stack *sstk, ssize_t segment);
+static void    wait_prefetch_idle(spill_stack *sstk);
+static void   *prefetch_routine(void *argument);
+
+static bool    write_segment(int descriptor, const void *buffer, size_t length, off_t offset);
+static bool    read_segment(int descriptor, void *buffer, size_t length, off_t offset);
+static size_t  get_segment_bytes(const spill_stack *sstk);
+
+ssize_t spill_stack_constructor(spill_stack *sstk, const char *file_name, ssize_t memory_budget)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(file_name != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+    MYASSERT(memory_budget > 0, NEGATIVE_VALUE_SIZE_T,       return CAPACITY_LESS_THAN_ZERO);
+
+    // The hot window peaks at two segments and the prefetch buffer holds a third.
+    sstk->segment_length = 1;
+
+    while (SPILL_WINDOW_SEGMENTS * sstk->segment_length * CAPACITY_MULTIPLIER * (ssize_t) sizeof(TYPE_ELEMENT_STACK) <= memory_budget)
+        sstk->segment_length *= CAPACITY_MULTIPLIER;
+
+    sstk->spilled_count     = 0;
+    sstk->hashes            = NULL;
+    sstk->hashes_capacity   = 0;
+
+    sstk->requested_segment = SPILL_NO_SEGMENT;
+    sstk->loaded_segment    = SPILL_NO_SEGMENT;
+    sstk->is_loading        = false;
+    sstk->is_stopping       = false;
+
+    sstk->prefetch_hits     = 0;
+    sstk->prefetch_misses   = 0;
+
+    sstk->hot = get_pointer_stack();
+
+    if (sstk->hot == NULL)
+        return POINTER_TO_STACK_IS_NULL;
+
+    STACK_CONSTRUCTOR(sstk->hot);
+
+    if (sstk->hot->error_code != NO_ERROR)
+    {
+        ssize_t error_code = sstk->hot->error_code;
+
+        // The destructor refuses a stack that fails its checks, so this one is released directly.
+        free(sstk->hot->info);
+        free(sstk->hot);
+
+        sstk->hot = NULL;
+
+        return error_code;
+    }
+
+    // An existing file or link at the path is an error, never something to truncate and unlink.
+    sstk->descriptor = open(file_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (sstk->descriptor < 0)
+    {
+        stack_destructor(sstk->hot);
+        return SPILL_SEGMENT_DAMAGED;
+    }
+
+    // The spill file has no meaning outside this stack, so it disappears with the descriptor.
+    unlink(file_name);
+
+    sstk->prefetch_buffer = (TYPE_ELEMENT_STACK *) calloc((size_t) sstk->segment_length, sizeof(TYPE_ELEMENT_STACK));
+
+    ssize_t error_code = POINTER_TO_STACK_DATA_IS_NULL;
+
+    if (sstk->prefetch_buffer != NULL)
+        error_code = start_prefetcher(sstk);
+
+    if (error_code != NO_ERROR)
+    {
+        free(sstk->prefetch_buffer);
+        close(sstk->descriptor);
+        stack_destructor(sstk->hot);
+
+        sstk->prefetch_buffer = NULL;
+        sstk->descriptor      = -1;
+        sstk->hot             = NULL;
+
+        return error_code;
+    }
+
+    return NO_ERROR;
+}
+
+ssize_t spill_stack_destructor(spill_stack *sstk)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    pthread_mutex_lock(&sstk->lock);
+
+    sstk->is_stopping = true;
+
+    pthread_cond_broadcast(&sstk->changed);
+    pthread_mutex_unlock(&sstk->lock);
+
+    pthread_join(sstk->prefetcher, NULL);
+
+    pthread_cond_destroy(&sstk->changed);
+    pthread_mutex_destroy(&sstk->lock);
+
+    ssize_t error_code = stack_destructor(sstk->hot);
+
+    if (close(sstk->descriptor) != 0)
+        error_code |= SPILL_SEGMENT_DAMAGED;
+
+    free(sstk->prefetch_buffer);
+    free(sstk->hashes);
+
+    sstk->hot             = NULL;
+    sstk->descriptor      = -1;
+    sstk->prefetch_buffer = NULL;
+    sstk->hashes          = NULL;
+    sstk->hashes_capacity = 0;
+    sstk->spilled_count   = 0;
+
+    return error_code;
+}
+
+ssize_t spill_push(spill_stack *sstk, TYPE_ELEMENT_STACK value)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = push(sstk->hot, value);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    if (sstk->hot->size >= CAPACITY_MULTIPLIER * sstk->segment_length)
+        return spill_bottom(sstk);
+
+    return NO_ERROR;
+}
+
+ssize_t spill_pop(spill_stack *sstk, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(sstk         != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (sstk->hot->size == 0 && sstk->spilled_count > 0)
+    {
+        ssize_t error_code = fill_from_spill(sstk);
+
+        if (error_code != NO_ERROR)
+            return error_code;
+    }
+
+    ssize_t error_code = pop(sstk->hot, return_value);
+
+    if (sstk->spilled_count > 0 && sstk->hot->size <= sstk->segment_length / CAPACITY_MULTIPLIER)
+        request_prefetch(sstk, sstk->spilled_count - 1);
+
+    return error_code;
+}
+
+ssize_t spill_stack_size(const spill_stack *sstk, ssize_t *size)
+{
+    MYASSERT(size      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    *size = sstk->spilled_count * sstk->segment_length + sstk->hot->size;
+
+    return NO_ERROR;
+}
+
+ssize_t verify_spill_stack(spill_stack *sstk)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = verify_stack(sstk->hot);
+
+    if (sstk->spilled_count == 0)
+        return error_code;
+
+    size_t segment_bytes = get_segment_bytes(sstk);
+
+    void *buffer = malloc(segment_bytes);
+
+    if (buffer == NULL)
+        return error_code | POINTER_TO_STACK_DATA_IS_NULL;
+
+    for (ssize_t segment = 0; segment < sstk->spilled_count; segment++)
+    {
+        if (!read_segment(sstk->descriptor, buffer, segment_bytes, (off_t) ((size_t) segment * segment_bytes)) ||
+            hash_buffer(buffer, (ssize_t) segment_bytes, (uint32_t) segment) != sstk->hashes[segment])
+        {
+            error_code |= SPILL_SEGMENT_DAMAGED;
+            break;
+        }
+    }
+
+    free(buffer);
+
+    return error_code;
+}
+
+ssize_t spill_bottom(spill_stack *sstk)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (sstk->spilled_count >= sstk->hashes_capacity)
+    {
+        ssize_t   capacity   = (sstk->hashes_capacity > 0) ? sstk->hashes_capacity * CAPACITY_MULTIPLIER : INITIAL_CAPACITY_VALUE;
+        uint32_t *new_hashes = (uint32_t *) realloc(sstk->hashes, (size_t) capacity * sizeof(uint32_t));
+
+        if (new_hashes == NULL)
+            return POINTER_TO_STACK_DATA_IS_NULL;
+
+        sstk->hashes          = new_hashes;
+        sstk->hashes_capacity = capacity;
+    }
+
+    ssize_t segment       = sstk->spilled_count;
+    size_t  segment_bytes = get_segment_bytes(sstk);
+    stack  *hot           = sstk->hot;
+
+    // The spilled segment leaves by shifting the whole window down, so all of it is opened up to the commit.
+    ssize_t error_code = stack_open(hot, 0, 0);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    // The slot being overwritten may still sit in the prefetch buffer from an earlier pop.
+    wait_prefetch_idle(sstk);
+
+    pthread_mutex_lock(&sstk->lock);
+
+    if (sstk->loaded_segment == segment)
+        sstk->loaded_segment = SPILL_NO_SEGMENT;
+
+    pthread_mutex_unlock(&sstk->lock);
+
+    if (!write_segment(sstk->descriptor, hot->data, segment_bytes, (off_t) ((size_t) segment * segment_bytes)))
+        return SPILL_SEGMENT_DAMAGED;
+
+    sstk->hashes[segment] = hash_buffer(hot->data, (ssize_t) segment_bytes, (uint32_t) segment);
+    sstk->spilled_count++;
+
+    ssize_t old_size = hot->size;
+
+    memmove(hot->data, hot->data + sstk->segment_length, (size_t) (old_size - sstk->segment_length) * sizeof(TYPE_ELEMENT_STACK));
+
+    return stack_commit(hot, old_size - sstk->segment_length, old_size);
+}
+
+ssize_t fill_from_spill(spill_stack *sstk)
+{
+    MYASSERT(sstk      != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(sstk->hot != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t segment       = sstk->spilled_count - 1;
+    size_t  segment_bytes = get_segment_bytes(sstk);
+
+    wait_prefetch_idle(sstk);
+
+    if (sstk->loaded_segment == segment)
+        sstk->prefetch_hits++;
+
+    else
+    {
+        sstk->prefetch_misses++;
+
+        if (!read_segment(sstk->descriptor, sstk->prefetch_buffer, segment_bytes, (off_t) ((size_t) segment * segment_bytes)))
+            return SPILL_SEGMENT_DAMAGED;
+    }
+
+    sstk->loaded_segment = SPILL_NO_SEGMENT;
+
+    if (hash_buffer(sstk->prefetch_buffer, (ssize_t) segment_bytes, (uint32_t) segment) != sstk->hashes[segment])
+        return SPILL_SEGMENT_DAMAGED;
+
+    ssize_t error_code = stack_reserve(sstk->hot, sstk->segment_length);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    memcpy(sstk->hot->data, sstk->prefetch_buffer, segment_bytes);
+
+    error_code = stack_commit(sstk->hot, sstk->segment_length, 0);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    sstk->spilled_count--;
+
+    return NO_ERROR;
+}
+
+ssize_t start_prefetcher(spill_stack *sstk)
+{
+    MYASSERT(sstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    if (pthread_mutex_init(&sstk->lock, NULL) != 0)
+        return LOCK_INIT_FAILED;
+
+    if (pthread_cond_init(&sstk->changed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&sstk->lock);
+        return LOCK_INIT_FAILED;
+    }
+
+    if (pthread_create(&sstk->prefetcher, NULL, prefetch_routine, sstk) != 0)
+    {
+        pthread_cond_destroy(&sstk->changed);
+        pthread_mutex_destroy(&sstk->lock);
+
+        return SPILL_SEGMENT_DAMAGED;
+    }
+
+    return NO_ERROR;
+}
+
+void request_prefetch(spill_stack *sstk, ssize_t segment)
+{
+    MYASSERT(sstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    pthread_mutex_lock(&sstk->lock);
+
+    if (sstk->loaded_segment != segment && sstk->requested_segment != segment && !sstk->is_loading)
+    {
+        sstk->requested_segment = segment;
+
+        pthread_cond_broadcast(&sstk->changed);
+    }
+
+    pthread_mutex_unlock(&sstk->lock);
+}
+
+void wait_prefetch_idle(spill_stack *sstk)
+{
+    MYASSERT(sstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+    pthread_mutex_lock(&sstk->lock);
+
+    while (sstk->is_loading || sstk->requested_segment != SPILL_NO_SEGMENT)
+        pthread_cond_wait(&sstk->changed, &sstk->lock);
+
+    pthread_mutex_unlock(&sstk->lock);
+}
+
+void *prefetch_routine(void *argument)
+{
+    spill_stack *sstk = (spill_stack *) argument;
+    MYASSERT(sstk != NULL, NULL_POINTER_PASSED_TO_FUNC, return NULL);
+
+    size_t segment_bytes = get_segment_bytes(sstk);
+
+    pthread_mutex_lock(&sstk->lock);
+
+    while (!sstk->is_stopping)
+    {
+        if (sstk->requested_segment == SPILL_NO_SEGMENT)
+        {
+            pthread_cond_wait(&sstk->changed, &sstk->lock);
+            continue;
+        }
+
+        ssize_t segment = sstk->requested_segment;
+
+        sstk->is_loading     = true;
+        sstk->loaded_segment = SPILL_NO_SEGMENT;
+
+        pthread_mutex_unlock(&sstk->lock);
+
+        bool is_read = read_segment(sstk->descriptor, sstk->prefetch_buffer, segment_bytes, (off_t) ((size_t) segment * segment_bytes));
+
+        pthread_mutex_lock(&sstk->lock);
+
+        sstk->is_loading        = false;
+        sstk->loaded_segment    = is_read ? segment : SPILL_NO_SEGMENT;
+        sstk->requested_segment = SPILL_NO_SEGMENT;
+
+        pthread_cond_broadcast(&sstk->changed);
+    }
+
+    pthread_mutex_unlock(&sstk->lock);
+
+    return NULL;
+}
+
+bool write_segment(int descriptor, const void *buffer, size_t length, off_t offset)
+{
+    MYASSERT(buffer != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    const char *position = (const char *) buffer;
+
+    while (length > 0)
+    {
+        ssize_t written = pwrite(descriptor, position, length, offset);
+
+        if (written <= 0)
+            return false;
+
+        position += written;
+        offset   += written;
+        length   -= (size_t) written;
+    }
+
+    return true;
+}
+
+bool read_segment(int descriptor, void *buffer, size_t length, off_t offset)
+{
+    MYASSERT(buffer != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+    char *position = (char *) buffer;
+
+    while (length > 0)
+    {
+        ssize_t was_read = pread(descriptor, position, length, offset);
+
+        if (was_read <= 0)
+            return false;
+
+        position += was_read;
+        offset   += was_read;
+        length   -= (size_t) was_read;
+    }
+
+    return true;
+}
+
+size_t get_segment_bytes(const spill_stack *sstk)
+{
+    return (size_t) sstk->segment_length * sizeof(TYPE_ELEMENT_STACK);
+}
@@ -6,6 +6,7 @@
 
 FILE *Global_logs_pointer = stderr;
 bool Global_color_output = true;
+int  Global_dump_descriptor = 2;
 
 #ifdef INCREASED_LEVEL_OF_PROTECTION
 
@@ -17,6 +18,12 @@ bool Global_color_output = true;
 
 #endif
 
+#ifdef HASH_PROTECT_INCLUDED
+
+    #include "hash_pool.h"
+
+#endif
+
 #ifdef DEBUG_OUTPUT_STACK_DUMP
 
     #define IF_ON_STACK_DUMP(...)   __VA_ARGS__
@@ -32,6 +39,87 @@ bool Global_color_output = true;
 
 #endif
 
+#ifdef DEBUG_OUTPUT_STACK_DUMP_BINARY
+
+    #include "stack_dump.h"
+    #include <string.h>
+    #include <errno.h>
+    #include <unistd.h>
+    #include <sys/uio.h>
+
+    #define IF_ON_STACK_DUMP_BINARY(...)   __VA_ARGS__
+
+    #define STACK_DUMP_BINARY(stk)                                          \
+    do {                                                                    \
+        stack_dump_binary(stk, __LINE__, __FILE__, __PRETTY_FUNCTION__);    \
+    } while(0)
+
+#else
+
+    #define IF_ON_STACK_DUMP_BINARY(...)
+
+#endif
+
+#if defined(DEBUG_OUTPUT_STACK_DUMP) || defined(DEBUG_OUTPUT_STACK_DUMP_BINARY)
+
+    #define IF_ON_ANY_STACK_DUMP(...)   __VA_ARGS__
+
+#else
+
+    #define IF_ON_ANY_STACK_DUMP(...)
+
+#endif
+
+#ifdef NUMA_BIND_INCLUDED
+
+    #include "numa_stack.h"
+
+    #define IF_ON_NUMA_BIND(...)   __VA_ARGS__
+
+#else
+
+    #define IF_ON_NUMA_BIND(...)
+
+#endif
+
+#ifdef SANITIZER_POISON_INCLUDED
+
+    #if __has_include(<sanitizer/asan_interface.h>)
+        #include <sanitizer/asan_interface.h>
+    #endif
+
+    #ifndef ASAN_POISON_MEMORY_REGION
+        #define ASAN_POISON_MEMORY_REGION(address, size)    ((void) (address), (void) (size))
+        #define ASAN_UNPOISON_MEMORY_REGION(address, size)  ((void) (address), (void) (size))
+    #endif
+
+    #ifdef __SANITIZE_ADDRESS__
+        #define IS_ADDRESS_POISONED(address)                __asan_address_is_poisoned(address)
+    #else
+        #define IS_ADDRESS_POISONED(address)                ((void) (address), false)
+    #endif
+
+    #if __has_include(<valgrind/memcheck.h>)
+        #include <valgrind/memcheck.h>
+    #else
+        #define VALGRIND_MAKE_MEM_NOACCESS(address, size)   ((void) (address), (void) (size), 0)
+        #define VALGRIND_MAKE_MEM_UNDEFINED(address, size)  ((void) (address), (void) (size), 0)
+    #endif
+
+    #define POISON_REGION(address, size)                                    \
+    do {                                                                    \
+        ASAN_POISON_MEMORY_REGION(address, size);                           \
+        (void) VALGRIND_MAKE_MEM_NOACCESS(address, size);                   \
+    } while(0)
+
+    #define UNPOISON_REGION(address, size)                                  \
+    do {                                                                    \
+        ASAN_UNPOISON_MEMORY_REGION(address, size);                         \
+        (void) VALGRIND_MAKE_MEM_UNDEFINED(address, size);                  \
+    } while(0)
+
+#endif
+
 #ifdef DEBUG_OUTPUT_STACK_OK
 
     #define IF_ON_STACK_OK(...)     __VA_ARGS__
@@ -56,11 +144,20 @@ IF_ON_CANARY_PROTECT
     const canary_t VALUE_RIGHT_CANARY_ARRAY = 0xDEDBAD;
 )
 
-static ssize_t verify_stack(stack *stk);
-
 static ssize_t check_capacity(stack *stk);
+static ssize_t resize_data(stack *stk, ssize_t new_size, ssize_t high_water);
+static ssize_t open_window(stack *stk, ssize_t from, ssize_t count);
 static ssize_t realloc_data(stack *stk);
+IF_ON_NUMA_BIND(static void bind_data_numa(stack *stk));
 static ssize_t fill_data_poison(stack *stk);
+static ssize_t fill_range_poison(stack *stk, ssize_t begin, ssize_t end);
+
+IF_ON_ANY_STACK_DUMP(static bool is_poisoned(const stack *stk, ssize_t index));
+
+IF_ON_SANITIZER_POISON
+(
+    static void unpoison_data(const stack *stk);
+)
 
 IF_ON_STACK_DUMP
 (
@@ -69,6 +166,12 @@ IF_ON_STACK_DUMP
     static void print_errors(const stack *stk);
 )
 
+IF_ON_STACK_DUMP_BINARY
+(
+    static void stack_dump_binary(stack *stk, ssize_t line, const char *file, const char *func);
+    static void write_iovec(int descriptor, struct iovec *iov, int iov_count);
+)
+
 IF_ON_STACK_OK(static void stack_ok(const stack *stk));
 
 IF_ON_CANARY_PROTECT
@@ -82,7 +185,9 @@ IF_ON_CANARY_PROTECT
 IF_ON_HASH_PROTECT
 (
     static ssize_t calculate_stack_hash(stack *stk);
+    static ssize_t calculate_hashes(stack *stk);
     static uint32_t calculate_hash(void *array, ssize_t size);
+    static uint32_t calculate_data_hash(const stack *stk);
     static bool check_stack_hash(stack *stk);
     static bool check_data_hash(stack *stk);
 )
@@ -97,6 +202,7 @@ stack *get_pointer_stack()
     stk->capacity       = 0;
     stk->error_code     = NO_ERROR;
     stk->info           = NULL;
+    stk->numa_node      = NUMA_NODE_ANY;
 
     IF_ON_CANARY_PROTECT
     (
@@ -106,6 +212,8 @@ stack *get_pointer_stack()
 
     IF_ON_HASH_PROTECT
     (
+        stk->hashed_size = 0;
+        stk->open_end = 0;
         stk->stack_hash = 0;
         stk->data_hash = 0;
     )
@@ -114,6 +222,12 @@ stack *get_pointer_stack()
 }
 
 ssize_t stack_constructor(stack *stk, debug_info *info)
+{
+    return stack_constructor_on_node(stk, info, NUMA_NODE_ANY);
+}
+
+// With NUMA_NODE_ANY the node comes from the NUMA policy, so a stack is only bound when something asked for it.
+ssize_t stack_constructor_on_node(stack *stk, debug_info *info, int node)
 {
     MYASSERT(stk  != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
     MYASSERT(info != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
@@ -122,6 +236,14 @@ ssize_t stack_constructor(stack *stk, debug_info *info)
 
     stk->capacity = INITIAL_CAPACITY_VALUE;
 
+    stk->numa_node = node;
+
+    IF_ON_NUMA_BIND
+    (
+        if (stk->numa_node == NUMA_NODE_ANY)
+            stk->numa_node = numa_choose_node();
+    )
+
     IF_ON_CANARY_PROTECT
     (
         canary_t *array = (canary_t *) calloc(get_size_data(stk), 1);
@@ -138,8 +260,12 @@ ssize_t stack_constructor(stack *stk, debug_info *info)
         MYASSERT(stk->data != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return POINTER_TO_STACK_DATA_IS_NULL);
     )
 
+    IF_ON_NUMA_BIND(bind_data_numa(stk));
+
     stk->size = 0;
 
+    IF_ON_SANITIZER_POISON(fill_data_poison(stk));
+
     IF_ON_HASH_PROTECT(calculate_stack_hash(stk));
 
     return (verify_stack(stk));
@@ -155,13 +281,15 @@ ssize_t stack_destructor(stack *stk)
 
     IF_ON_CANARY_PROTECT
     (
-        memset(get_pointer_left_canary(stk), POISON, get_size_data(stk));
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+        ELSE_IF_OFF_SANITIZER_POISON(memset(get_pointer_left_canary(stk), POISON, get_size_data(stk)));
         free(get_pointer_left_canary(stk));
     )
 
     ELSE_IF_OFF_CANARY_PROTECT
     (
-        memset(stk->data, POISON, (size_t) stk->capacity);
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+        ELSE_IF_OFF_SANITIZER_POISON(memset(stk->data, POISON, (size_t) stk->capacity));
         free(stk->data);
     )
 
@@ -189,6 +317,8 @@ ssize_t push(stack *stk, TYPE_ELEMENT_STACK value)
 
     check_capacity(stk);
 
+    IF_ON_SANITIZER_POISON(UNPOISON_REGION(stk->data + stk->size, sizeof(TYPE_ELEMENT_STACK)));
+
     (stk->data)[stk->size++] = value;
 
     IF_ON_HASH_PROTECT(calculate_stack_hash(stk));
@@ -213,7 +343,9 @@ ssize_t pop(stack *stk, TYPE_ELEMENT_STACK *return_value)
     --stk->size;
 
     *return_value = (stk->data)[stk->size];
-    (stk->data)[stk->size] = POISON;
+
+    IF_ON_SANITIZER_POISON(POISON_REGION(stk->data + stk->size, sizeof(TYPE_ELEMENT_STACK)));
+    ELSE_IF_OFF_SANITIZER_POISON((stk->data)[stk->size] = POISON);
 
     IF_ON_HASH_PROTECT(calculate_stack_hash(stk));
 
@@ -224,6 +356,177 @@ ssize_t pop(stack *stk, TYPE_ELEMENT_STACK *return_value)
     return NO_ERROR;
 }
 
+ssize_t stack_mark(stack *stk, ssize_t *mark)
+{
+    MYASSERT(mark         != NULL, NULL_POINTER_PASSED_TO_FUNC, return INVALID_STACK_MARK);
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    CHECK_ERRORS(stk);
+
+    *mark = stk->size;
+
+    return NO_ERROR;
+}
+
+ssize_t stack_rollback(stack *stk, ssize_t mark)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    CHECK_ERRORS(stk);
+
+    if (mark < 0 || mark > stk->size)
+        return INVALID_STACK_MARK;
+
+    if (mark == stk->size)
+        return NO_ERROR;
+
+    return resize_data(stk, mark, stk->size);
+}
+
+ssize_t stack_reserve(stack *stk, ssize_t count)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    return stack_open(stk, stk->size, count);
+}
+
+// Opens [from, size + count) for direct writes until the next stack_commit. The elements below from and the tail
+// above the window stay sealed, so commit can still verify them before it takes the new contents.
+ssize_t stack_open(stack *stk, ssize_t from, ssize_t count)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+    MYASSERT(count        >= 0,    NEGATIVE_VALUE_SIZE_T,       return SIZE_LESS_THAN_ZERO);
+
+    CHECK_ERRORS(stk);
+
+    if (from < 0 || from > stk->size)
+        return INVALID_STACK_MARK;
+
+    return open_window(stk, from, count);
+}
+
+ssize_t stack_commit(stack *stk, ssize_t new_size, ssize_t high_water)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    CHECK_ERRORS(stk);
+
+    if (new_size < 0)
+        return SIZE_LESS_THAN_ZERO;
+
+    if (new_size > stk->capacity)
+        return SIZE_MORE_THAN_CAPACITY;
+
+    if (high_water > stk->capacity)
+        high_water = stk->capacity;
+
+    return resize_data(stk, new_size, high_water);
+}
+
+// stack_commit followed by stack_open, for callers that fill the stack window after window. The stack is verified
+// once on the way in and hashed once on the way out. The next window is opened right away, so the capacity
+// is only grown here and left for a plain commit to trim.
+ssize_t stack_commit_open(stack *stk, ssize_t new_size, ssize_t high_water, ssize_t from, ssize_t count)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+    MYASSERT(count        >= 0,    NEGATIVE_VALUE_SIZE_T,       return SIZE_LESS_THAN_ZERO);
+
+    CHECK_ERRORS(stk);
+
+    if (new_size < 0)
+        return SIZE_LESS_THAN_ZERO;
+
+    if (new_size > stk->capacity)
+        return SIZE_MORE_THAN_CAPACITY;
+
+    if (from < 0 || from > new_size)
+        return INVALID_STACK_MARK;
+
+    if (high_water > stk->capacity)
+        high_water = stk->capacity;
+
+    stk->size = new_size;
+
+    fill_range_poison(stk, new_size, high_water);
+
+    return open_window(stk, from, count);
+}
+
+ssize_t open_window(stack *stk, ssize_t from, ssize_t count)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    if (stk->size + count > stk->capacity)
+    {
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+
+        while (stk->size + count > stk->capacity)
+            stk->capacity *= CAPACITY_MULTIPLIER;
+
+        realloc_data(stk);
+
+        CHECK_ERRORS(stk);
+    }
+
+    IF_ON_SANITIZER_POISON(UNPOISON_REGION(stk->data + stk->size, (size_t) count * sizeof(TYPE_ELEMENT_STACK)));
+
+    IF_ON_HASH_PROTECT
+    (
+        stk->hashed_size = from;
+        stk->open_end    = stk->size + count;
+
+        calculate_hashes(stk);
+    )
+
+    return NO_ERROR;
+}
+
+ssize_t resize_data(stack *stk, ssize_t new_size, ssize_t high_water)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
+
+    ssize_t capacity = stk->capacity;
+
+    while ((new_size + 1) * CAPACITY_MULTIPLIER * CAPACITY_MULTIPLIER <= capacity)
+        capacity /= CAPACITY_MULTIPLIER;
+
+    stk->size = new_size;
+
+    if (capacity != stk->capacity)
+    {
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+
+        stk->capacity = capacity;
+
+        realloc_data(stk);
+    }
+
+    else
+    {
+        fill_range_poison(stk, new_size, high_water);
+
+        IF_ON_HASH_PROTECT(calculate_stack_hash(stk));
+    }
+
+    CHECK_ERRORS(stk);
+
+    return NO_ERROR;
+}
+
 ssize_t check_capacity(stack *stk)
 {
     MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
@@ -234,6 +537,8 @@ ssize_t check_capacity(stack *stk)
 
     if (stk->size >= stk->capacity)
     {
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+
         stk->capacity *= CAPACITY_MULTIPLIER;
 
         realloc_data(stk);
@@ -241,6 +546,8 @@ ssize_t check_capacity(stack *stk)
 
     else if ((stk->size + 1) * CAPACITY_MULTIPLIER * CAPACITY_MULTIPLIER <= stk->capacity)
     {
+        IF_ON_SANITIZER_POISON(unpoison_data(stk));
+
         stk->capacity /= CAPACITY_MULTIPLIER;
 
         realloc_data(stk);
@@ -273,6 +580,8 @@ ssize_t realloc_data(stack *stk)
         MYASSERT(stk->data != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return 0);
     )
 
+    IF_ON_NUMA_BIND(bind_data_numa(stk));
+
     fill_data_poison(stk);
 
     IF_ON_HASH_PROTECT(calculate_stack_hash(stk));
@@ -282,18 +591,78 @@ ssize_t realloc_data(stack *stk)
     return NO_ERROR;
 }
 
+IF_ON_NUMA_BIND
+(
+    void bind_data_numa(stack *stk)
+    {
+        MYASSERT(stk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(stk->data != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+        if (stk->numa_node == NUMA_NODE_ANY)
+            return;
+
+        IF_ON_CANARY_PROTECT      (numa_bind_memory(get_pointer_left_canary(stk), get_size_data(stk), stk->numa_node));
+        ELSE_IF_OFF_CANARY_PROTECT(numa_bind_memory(stk->data, (size_t) stk->capacity * sizeof(TYPE_ELEMENT_STACK), stk->numa_node));
+    }
+)
+
 ssize_t fill_data_poison(stack *stk)
 {
     MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
     MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
     MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
 
-    for (ssize_t index = stk->size; index < stk->capacity; index++)
-        (stk->data)[index] = POISON;
+    return fill_range_poison(stk, stk->size, stk->capacity);
+}
+
+ssize_t fill_range_poison(stack *stk, ssize_t begin, ssize_t end)
+{
+    MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+    MYASSERT(begin >= 0 && end <= stk->capacity, GOING_BEYOUND_BOUNDARY_ARRAY, return SIZE_MORE_THAN_CAPACITY);
+
+    // stack_reserve may have opened slots past end, so the sanitizer marks the whole tail again.
+    IF_ON_SANITIZER_POISON
+    (
+        (void) end;
+
+        POISON_REGION(stk->data + begin, (size_t) (stk->capacity - begin) * sizeof(TYPE_ELEMENT_STACK));
+    )
+
+    ELSE_IF_OFF_SANITIZER_POISON
+    (
+        for (ssize_t index = begin; index < end; index++)
+            (stk->data)[index] = POISON;
+    )
 
     return NO_ERROR;
 }
 
+IF_ON_ANY_STACK_DUMP
+(
+    bool is_poisoned(const stack *stk, ssize_t index)
+    {
+        MYASSERT(stk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+        MYASSERT(stk->data != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
+
+        // A damaged size must not lead the dump into slots the sanitizer still guards.
+        IF_ON_SANITIZER_POISON(return index >= stk->size || IS_ADDRESS_POISONED(stk->data + index);)
+        ELSE_IF_OFF_SANITIZER_POISON(return (stk->data)[index] == POISON;)
+    }
+)
+
+IF_ON_SANITIZER_POISON
+(
+    void unpoison_data(const stack *stk)
+    {
+        MYASSERT(stk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(stk->data != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+        IF_ON_CANARY_PROTECT      (UNPOISON_REGION(get_pointer_left_canary(stk), get_size_data(stk)));
+        ELSE_IF_OFF_CANARY_PROTECT(UNPOISON_REGION(stk->data, (size_t) stk->capacity * sizeof(TYPE_ELEMENT_STACK)));
+    }
+)
+
 ssize_t verify_stack(stack *stk)
 {
     MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
@@ -341,6 +710,12 @@ ssize_t verify_stack(stack *stk)
             STACK_DUMP(stk);
     )
 
+    IF_ON_STACK_DUMP_BINARY
+    (
+        if (error_code != NO_ERROR)
+            STACK_DUMP_BINARY(stk);
+    )
+
     IF_ON_STACK_OK
     (
         if (error_code == NO_ERROR)
@@ -366,7 +741,7 @@ IF_ON_STACK_DUMP
 
         for (ssize_t index = 0; index < stk->capacity; index++)
         {
-            if ((stk->data)[index] == POISON)
+            if (is_poisoned(stk, index))
             {
                 fprintf(Global_logs_pointer, "\t\t [%ld] = " FORMAT_SPECIFIERS_STACK, index, POISON);
 
@@ -472,6 +847,14 @@ IF_ON_STACK_DUMP
         GET_ERRORS_(CAPACITY_LESS_THAN_ZERO);
         GET_ERRORS_(SIZE_LESS_THAN_ZERO);
         GET_ERRORS_(SIZE_NULL_IN_POP);
+        GET_ERRORS_(INVALID_STACK_MARK);
+        GET_ERRORS_(STACK_IS_FULL);
+        GET_ERRORS_(WAIT_TIMED_OUT);
+        GET_ERRORS_(BAD_SHARED_SEGMENT);
+        GET_ERRORS_(COMPRESSED_BLOCK_DAMAGED);
+        GET_ERRORS_(SPILL_SEGMENT_DAMAGED);
+        GET_ERRORS_(POOL_STILL_IN_USE);
+        GET_ERRORS_(LOCK_INIT_FAILED);
 
         IF_ON_CANARY_PROTECT
         (
@@ -491,6 +874,184 @@ IF_ON_STACK_DUMP
     }
 )
 
+IF_ON_STACK_DUMP_BINARY
+(
+    void stack_dump_binary(stack *stk, ssize_t line, const char *file, const char *func)
+    {
+        MYASSERT(stk                 != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(stk->data           != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(stk->info           != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(file                != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+        MYASSERT(func                != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+        stack_dump_header header = {};
+
+        const char *strings[DUMP_STRINGS_COUNT] = {};
+
+        strings[DUMP_STRING_NAME]       = stk->info->name;
+        strings[DUMP_STRING_FILE]       = stk->info->file;
+        strings[DUMP_STRING_FUNC]       = stk->info->func;
+        strings[DUMP_STRING_CALL_FILE]  = file;
+        strings[DUMP_STRING_CALL_FUNC]  = func;
+
+        static char padding[DUMP_ALIGNMENT] = {};
+
+        struct iovec iov[DUMP_STRINGS_COUNT + 6] = {};
+        int iov_count = 0;
+
+        iov[iov_count++] = {&header, sizeof(header)};
+
+        for (int index = 0; index < DUMP_STRINGS_COUNT; index++)
+        {
+            const char *string = (strings[index] != NULL) ? strings[index] : "";
+            size_t length = strlen(string) + 1;
+
+            iov[iov_count++] = {const_cast<char *>(string), length};
+            header.strings_length += length;
+        }
+
+        size_t strings_padding = (DUMP_ALIGNMENT - header.strings_length % DUMP_ALIGNMENT) % DUMP_ALIGNMENT;
+
+        iov[iov_count++] = {padding, strings_padding};
+        header.strings_length += strings_padding;
+
+        size_t capacity      = (stk->capacity > 0) ? (size_t) stk->capacity : 0;
+        size_t data_length   = capacity * sizeof(TYPE_ELEMENT_STACK);
+        size_t bitmap_length = (capacity + 7) / 8;
+
+        IF_ON_SANITIZER_POISON
+        (
+            // The poisoned tail cannot be handed to writev, so zeros stand in for it.
+            ssize_t live_count = 0;
+
+            while (live_count < (ssize_t) capacity && !is_poisoned(stk, live_count))
+                live_count++;
+
+            size_t live_length = (size_t) live_count * sizeof(TYPE_ELEMENT_STACK);
+
+            char *poisoned_tail = (char *) calloc(data_length - live_length + 1, 1);
+
+            iov[iov_count++] = {stk->data, live_length};
+            iov[iov_count++] = {poisoned_tail, data_length - live_length};
+        )
+
+        ELSE_IF_OFF_SANITIZER_POISON(iov[iov_count++] = {stk->data, data_length});
+
+        uint8_t *bitmap = (uint8_t *) calloc(bitmap_length + 1, 1);
+
+        // Without its buffers the record would not match its own header, and no record beats a truncated one.
+        IF_ON_SANITIZER_POISON
+        (
+            if (poisoned_tail == NULL || bitmap == NULL)
+            {
+                free(poisoned_tail);
+                free(bitmap);
+
+                return;
+            }
+        )
+
+        ELSE_IF_OFF_SANITIZER_POISON
+        (
+            if (bitmap == NULL)
+                return;
+        )
+
+        for (ssize_t index = 0; index < (ssize_t) capacity; index++)
+            if (is_poisoned(stk, index))
+                bitmap[index / 8] = (uint8_t) (bitmap[index / 8] | (1 << (index % 8)));
+
+        header.flags |= DUMP_HAS_BITMAP;
+        iov[iov_count++] = {bitmap, bitmap_length};
+
+        header.magic            = STACK_DUMP_MAGIC;
+        header.version          = STACK_DUMP_VERSION;
+        header.element_size     = sizeof(TYPE_ELEMENT_STACK);
+
+        header.size             = stk->size;
+        header.capacity         = (int64_t) capacity;
+        header.error_code       = stk->error_code;
+
+        header.info_line        = stk->info->line;
+        header.call_line        = line;
+
+        header.stack_address    = (uint64_t) stk;
+        header.data_address     = (uint64_t) stk->data;
+
+        IF_ON_CANARY_PROTECT
+        (
+            header.flags |= DUMP_HAS_CANARY;
+
+            header.left_canary_array_address  = (uint64_t) get_pointer_left_canary(stk);
+            header.right_canary_array_address = (uint64_t) get_pointer_right_canary(stk);
+
+            header.canaries[DUMP_LEFT_CANARY_STACK]   = stk->left_canary;
+            header.canaries[DUMP_RIGHT_CANARY_STACK]  = stk->right_canary;
+            header.canaries[DUMP_LEFT_CANARY_ARRAY]   = *get_pointer_left_canary(stk);
+            header.canaries[DUMP_RIGHT_CANARY_ARRAY]  = *get_pointer_right_canary(stk);
+
+            header.reference_canaries[DUMP_LEFT_CANARY_STACK]   = VALUE_LEFT_CANARY_STACK;
+            header.reference_canaries[DUMP_RIGHT_CANARY_STACK]  = VALUE_RIGHT_CANARY_STACK;
+            header.reference_canaries[DUMP_LEFT_CANARY_ARRAY]   = VALUE_LEFT_CANARY_ARRAY;
+            header.reference_canaries[DUMP_RIGHT_CANARY_ARRAY]  = VALUE_RIGHT_CANARY_ARRAY;
+        )
+
+        IF_ON_HASH_PROTECT
+        (
+            header.flags |= DUMP_HAS_HASH;
+
+            header.stack_hash = stk->stack_hash;
+            header.data_hash  = stk->data_hash;
+        )
+
+        header.record_length = sizeof(header) + header.strings_length + data_length + bitmap_length;
+
+        size_t record_padding = (DUMP_ALIGNMENT - header.record_length % DUMP_ALIGNMENT) % DUMP_ALIGNMENT;
+
+        iov[iov_count++] = {padding, record_padding};
+        header.record_length += record_padding;
+
+        write_iovec(Global_dump_descriptor, iov, iov_count);
+
+        IF_ON_SANITIZER_POISON(free(poisoned_tail));
+
+        free(bitmap);
+    }
+)
+
+IF_ON_STACK_DUMP_BINARY
+(
+    void write_iovec(int descriptor, struct iovec *iov, int iov_count)
+    {
+        MYASSERT(iov != NULL, NULL_POINTER_PASSED_TO_FUNC, return);
+
+        while (iov_count > 0)
+        {
+            ssize_t written = writev(descriptor, iov, iov_count);
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written < 0)
+                return;
+
+            while (iov_count > 0 && (size_t) written >= iov->iov_len)
+            {
+                written -= (ssize_t) iov->iov_len;
+
+                iov++;
+                iov_count--;
+            }
+
+            if (iov_count > 0)
+            {
+                iov->iov_base = (char *) iov->iov_base + written;
+                iov->iov_len -= (size_t) written;
+            }
+        }
+    }
+)
+
 IF_ON_CANARY_PROTECT
 (
     void print_canary(const stack *stk, canary_t canary, canary_t reference_value_canary)
@@ -576,20 +1137,25 @@ IF_ON_HASH_PROTECT
         MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
         MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_INFO_IS_NULL);
 
+        stk->hashed_size = stk->size;
+        stk->open_end    = stk->size;
+
+        return calculate_hashes(stk);
+    }
+)
+
+IF_ON_HASH_PROTECT
+(
+    ssize_t calculate_hashes(stack *stk)
+    {
+        MYASSERT(stk          != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+        MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_DATA_IS_NULL);
+
         stk->stack_hash = 0;
         stk->data_hash  = 0;
 
-        IF_ON_CANARY_PROTECT
-        (
-            stk->stack_hash = calculate_hash(stk, sizeof(*stk));
-            stk->data_hash  = calculate_hash(get_pointer_left_canary(stk), get_size_data(stk));
-        )
-
-        ELSE_IF_OFF_CANARY_PROTECT
-        (
-            stk->stack_hash = calculate_hash(stk, sizeof(*stk));
-            stk->data_hash  = calculate_hash(stk->data, stk->capacity);
-        )
+        stk->stack_hash = calculate_hash(stk, sizeof(*stk));
+        stk->data_hash  = calculate_data_hash(stk);
 
         return NO_ERROR;
     }
@@ -602,23 +1168,64 @@ IF_ON_HASH_PROTECT
         MYASSERT(array != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
         MYASSERT(size > 0,      NEGATIVE_VALUE_SIZE_T,       return 0);
 
-        uint32_t hash = (uint32_t)((size_t) array);
+        return hash_buffer(array, size, (uint32_t)((size_t) array));
+    }
+)
 
-        for(ssize_t counter = 0; counter < size; counter++)
-        {
-            hash += *((char *) array + counter);
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
-        }
+IF_ON_HASH_PROTECT
+(
+    uint32_t calculate_data_hash(const stack *stk)
+    {
+        MYASSERT(stk       != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+        MYASSERT(stk->data != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+
+        // Everything but the window open for stack_commit is hashed, so a write into the tail above size is caught.
+        // With the sanitizer the tail is poisoned instead and cannot be read.
+        ssize_t begin = (stk->hashed_size < 0) ? 0 : (stk->hashed_size > stk->capacity) ? stk->capacity : stk->hashed_size;
 
-        hash += (hash << 3);
-        hash ^= (hash >> 11);
-        hash += (hash << 15);
+        uint32_t hash = hash_chunked(stk->data, begin * (ssize_t) sizeof(TYPE_ELEMENT_STACK), (uint32_t)((size_t) stk->data));
 
-        return hash;
+        IF_ON_SANITIZER_POISON(return hash;)
+
+        ELSE_IF_OFF_SANITIZER_POISON
+        (
+            ssize_t end = (stk->open_end < begin) ? begin : (stk->open_end > stk->capacity) ? stk->capacity : stk->open_end;
+
+            return hash_chunked(stk->data + end, (stk->capacity - end) * (ssize_t) sizeof(TYPE_ELEMENT_STACK), hash);
+        )
     }
 )
 
+uint32_t hash_buffer(const void *array, ssize_t size, uint32_t seed)
+{
+    return hash_buffer_finish(hash_buffer_update(array, size, seed));
+}
+
+// hash_buffer split in two: a buffer fed through several updates hashes the same as in one piece.
+uint32_t hash_buffer_update(const void *array, ssize_t size, uint32_t hash)
+{
+    MYASSERT(array != NULL, NULL_POINTER_PASSED_TO_FUNC, return 0);
+    MYASSERT(size >= 0,     NEGATIVE_VALUE_SIZE_T,       return 0);
+
+    for(ssize_t counter = 0; counter < size; counter++)
+    {
+        hash += *((const char *) array + counter);
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+
+    return hash;
+}
+
+uint32_t hash_buffer_finish(uint32_t hash)
+{
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+
+    return hash;
+}
+
 IF_ON_HASH_PROTECT
 (
     bool check_stack_hash(stack *stk)
@@ -656,18 +1263,6 @@ IF_ON_HASH_PROTECT
         MYASSERT(stk->data    != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
         MYASSERT(stk->info    != NULL, NULL_POINTER_PASSED_TO_FUNC, return false);
 
-        IF_ON_CANARY_PROTECT
-        (
-            if (stk->data_hash != calculate_hash(get_pointer_left_canary(stk), get_size_data(stk)))
-                return false;
-        )
-
-        ELSE_IF_OFF_CANARY_PROTECT
-        (
-            if (stk->data_hash != calculate_hash(stk->data, stk->capacity))
-                return false;
-        )
-
-        return true;
+        return stk->data_hash == calculate_data_hash(stk);
     }
 )
@@ -0,0 +1,922 @@
+#include "vm.h"
+#include "myassert.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+struct vm_opcode_info {
+    const char                     *name;
+    bool                            has_operand;
+    ssize_t                         pops;
+    ssize_t                         pushes;
+};
+
+const vm_opcode_info OPCODES_INFO[VM_OPCODES_COUNT] = {
+    {"hlt",  false, 0, 0},
+    {"push", true,  0, 1},
+    {"pop",  false, 1, 0},
+    {"dup",  false, 1, 2},
+    {"swap", false, 2, 2},
+    {"over", false, 2, 3},
+    {"add",  false, 2, 1},
+    {"sub",  false, 2, 1},
+    {"mul",  false, 2, 1},
+    {"div",  false, 2, 1},
+    {"mod",  false, 2, 1},
+    {"neg",  false, 1, 1},
+    {"eq",   false, 2, 1},
+    {"lt",   false, 2, 1},
+    {"jmp",  true,  0, 0},
+    {"jz",   true,  1, 0},
+    {"jnz",  true,  1, 0},
+    {"call", true,  0, 0},
+    {"ret",  false, 0, 0},
+    {"out",  false, 1, 0}
+};
+
+struct vm_label {
+    char                            name[VM_MAX_LABEL_LENGTH];
+    ssize_t                         address;
+};
+
+struct vm_labels {
+    vm_label                       *labels;
+    ssize_t                         size;
+    ssize_t                         capacity;
+};
+
+static ssize_t assemble_pass(const char *source, vm_program *program, vm_labels *labels, bool emit, ssize_t *error_line);
+static ssize_t read_token(const char **cursor, char *token);
+static ssize_t find_opcode(const char *token);
+static ssize_t find_label(const vm_labels *labels, const char *name);
+static ssize_t add_label(vm_labels *labels, const char *name, ssize_t address);
+static ssize_t parse_operand(const char *token, const vm_labels *labels, int32_t opcode, int32_t *operand);
+
+static ssize_t prepare_program(vm_program *program);
+static ssize_t analyze_block(vm_program *program, ssize_t entry);
+static bool is_jump(int32_t opcode);
+static bool is_block_end(int32_t opcode);
+
+ssize_t vm_assemble(const char *source, vm_program *program, ssize_t *error_line)
+{
+    MYASSERT(source     != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(program    != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(error_line != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+
+    vm_labels labels = {};
+
+    *program    = {};
+    *error_line = 0;
+
+    ssize_t error_code = assemble_pass(source, program, &labels, false, error_line);
+
+    if (error_code == VM_NO_ERROR)
+    {
+        program->code = (vm_instruction *) calloc((size_t) program->length + 1, sizeof(vm_instruction));
+        MYASSERT(program->code != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, free(labels.labels); return VM_BAD_BYTECODE);
+
+        error_code = assemble_pass(source, program, &labels, true, error_line);
+    }
+
+    free(labels.labels);
+
+    if (error_code == VM_NO_ERROR)
+        error_code = prepare_program(program);
+
+    if (error_code != VM_NO_ERROR)
+        vm_program_destructor(program);
+
+    return error_code;
+}
+
+ssize_t vm_save_program(const vm_program *program, const char *file_name)
+{
+    MYASSERT(program       != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program->code != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(file_name     != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    FILE *file_pointer = fopen(file_name, "wb");
+    MYASSERT(file_pointer != NULL, COULD_NOT_OPEN_THE_FILE, return VM_BAD_BYTECODE);
+
+    if (file_pointer == NULL)
+        return VM_BAD_BYTECODE;
+
+    vm_bytecode_header header = {};
+
+    header.magic   = VM_BYTECODE_MAGIC;
+    header.version = VM_BYTECODE_VERSION;
+    header.length  = (uint32_t) program->length;
+
+    bool is_written = fwrite(&header, sizeof(header), 1, file_pointer) == 1 &&
+                      fwrite(program->code, sizeof(vm_instruction), (size_t) program->length, file_pointer) == (size_t) program->length;
+
+    if (fclose(file_pointer) != 0 || !is_written)
+        return VM_BAD_BYTECODE;
+
+    return VM_NO_ERROR;
+}
+
+ssize_t vm_load_program(const char *file_name, vm_program *program)
+{
+    MYASSERT(file_name != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program   != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    *program = {};
+
+    FILE *file_pointer = fopen(file_name, "rb");
+    MYASSERT(file_pointer != NULL, COULD_NOT_OPEN_THE_FILE, return VM_BAD_BYTECODE);
+
+    if (file_pointer == NULL)
+        return VM_BAD_BYTECODE;
+
+    vm_bytecode_header header = {};
+
+    if (fread(&header, sizeof(header), 1, file_pointer) != 1 ||
+        header.magic != VM_BYTECODE_MAGIC || header.version != VM_BYTECODE_VERSION)
+    {
+        fclose(file_pointer);
+        return VM_BAD_BYTECODE;
+    }
+
+    program->length = header.length;
+    program->code   = (vm_instruction *) calloc((size_t) program->length + 1, sizeof(vm_instruction));
+
+    bool is_read = program->code != NULL &&
+                   fread(program->code, sizeof(vm_instruction), header.length, file_pointer) == header.length;
+
+    fclose(file_pointer);
+
+    ssize_t error_code = VM_BAD_BYTECODE;
+
+    if (is_read)
+        error_code = prepare_program(program);
+
+    if (error_code != VM_NO_ERROR)
+        vm_program_destructor(program);
+
+    return error_code;
+}
+
+ssize_t vm_program_destructor(vm_program *program)
+{
+    MYASSERT(program != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    free(program->code);
+    free(program->blocks);
+    free(program->cells);
+
+    *program = {};
+
+    return VM_NO_ERROR;
+}
+
+ssize_t vm_constructor(vm_machine *vm, FILE *output)
+{
+    MYASSERT(vm != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    vm->operands = get_pointer_stack();
+    vm->calls    = get_pointer_stack();
+    vm->output   = output;
+
+    STACK_CONSTRUCTOR(vm->operands);
+    STACK_CONSTRUCTOR(vm->calls);
+
+    // Bottom slot is never visible to programs: it lets the cached top of stack be spilled unconditionally.
+    return push(vm->operands, 0);
+}
+
+ssize_t vm_destructor(vm_machine *vm)
+{
+    MYASSERT(vm != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+
+    ssize_t error_code = stack_destructor(vm->operands) | stack_destructor(vm->calls);
+
+    vm->operands = NULL;
+    vm->calls    = NULL;
+
+    return error_code;
+}
+
+ssize_t vm_pop_result(vm_machine *vm, TYPE_ELEMENT_STACK *return_value)
+{
+    MYASSERT(vm           != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(return_value != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_RETURN_VALUE_POP_NULL);
+
+    if (vm->operands->size <= 1)
+        return SIZE_NULL_IN_POP;
+
+    return pop(vm->operands, return_value);
+}
+
+ssize_t vm_run(vm_machine *vm, vm_program *program)
+{
+    MYASSERT(vm            != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(program       != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program->code != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    static const void *HANDLERS[VM_OPCODES_COUNT] = {
+        &&op_hlt,  &&op_push, &&op_pop,  &&op_dup,  &&op_swap, &&op_over, &&op_add,  &&op_sub,  &&op_mul,  &&op_div,
+        &&op_mod,  &&op_neg,  &&op_eq,   &&op_lt,   &&op_jmp,  &&op_jz,   &&op_jnz,  &&op_call, &&op_ret,  &&op_out
+    };
+
+    if (program->cells == NULL)
+    {
+        program->cells = (vm_cell *) calloc((size_t) program->length, sizeof(vm_cell));
+        MYASSERT(program->cells != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return VM_BAD_BYTECODE);
+
+        if (program->cells == NULL)
+            return VM_BAD_BYTECODE;
+
+        for (ssize_t index = 0; index < program->length; index++)
+        {
+            program->cells[index].handler = HANDLERS[program->code[index].opcode];
+            program->cells[index].operand = program->code[index].operand;
+        }
+    }
+
+    stack              *operands    = vm->operands;
+    stack              *calls       = vm->calls;
+    const vm_cell      *cells       = program->cells;
+    const vm_cell      *cell        = cells;
+    const vm_block     *block       = NULL;
+
+    TYPE_ELEMENT_STACK *sp          = NULL;
+    TYPE_ELEMENT_STACK  tos         = 0;
+    TYPE_ELEMENT_STACK  value       = 0;
+
+    ssize_t             high_water  = 0;
+    ssize_t             target      = 0;
+    ssize_t             error_code  = NO_ERROR;
+
+    // sp points at the home slot of the cached top of stack, everything below it is in memory.
+    // The buffer is only written back and verified when control leaves a basic block: one call to
+    // stack_commit_open seals the finished block and opens the next. calls keeps one open slot above
+    // its top the same way, so a call or a return also checks that stack once.
+    #define DISPATCH_()     goto *(cell->handler)
+    #define NEXT_()         do { cell++; DISPATCH_(); } while(0)
+
+    #define SAVE_STATE_()                                                                   \
+    do {                                                                                    \
+        *sp = tos;                                                                          \
+        error_code = stack_commit(operands, sp - operands->data + 1, high_water) |          \
+                     stack_commit(calls, calls->size, calls->size + 1);                     \
+    } while(0)
+
+    #define ENTER_BLOCK_(address)                                                           \
+    do {                                                                                    \
+        target = (address);                                                                 \
+        goto enter_block;                                                                   \
+    } while(0)
+
+    if ((error_code = stack_open(calls, calls->size, 1)) != NO_ERROR)
+        return error_code;
+
+    sp         = operands->data + operands->size - 1;
+    tos        = *sp;
+    high_water = operands->size;
+
+enter_block:
+    if (target < 0 || target >= program->length)
+        goto bad_jump_address;
+
+    block = program->blocks + target;
+
+    if (sp - operands->data < block->need)
+        goto stack_underflow;
+
+    *sp = tos;
+
+    // The block rewrites the cached top and up to need slots below it, so those are opened along with the growth.
+    error_code = stack_commit_open(operands, sp - operands->data + 1, high_water, sp - operands->data - block->need, block->growth);
+
+    if (error_code != NO_ERROR)
+        goto stack_error;
+
+    high_water = operands->size + block->growth;
+
+    sp   = operands->data + operands->size - 1;
+    cell = cells + target;
+
+    DISPATCH_();
+
+op_hlt:
+    SAVE_STATE_();
+    return error_code;
+
+op_push:
+    *sp++ = tos;
+    tos = cell->operand;
+    NEXT_();
+
+op_pop:
+    tos = *--sp;
+    NEXT_();
+
+op_dup:
+    *sp++ = tos;
+    NEXT_();
+
+op_swap:
+    value = sp[-1];
+    sp[-1] = tos;
+    tos = value;
+    NEXT_();
+
+op_over:
+    *sp++ = tos;
+    tos = sp[-2];
+    NEXT_();
+
+op_add:
+    if (__builtin_add_overflow(sp[-1], tos, &value))
+        goto arithmetic_overflow;
+
+    sp--;
+    tos = value;
+    NEXT_();
+
+op_sub:
+    if (__builtin_sub_overflow(sp[-1], tos, &value))
+        goto arithmetic_overflow;
+
+    sp--;
+    tos = value;
+    NEXT_();
+
+op_mul:
+    if (__builtin_mul_overflow(sp[-1], tos, &value))
+        goto arithmetic_overflow;
+
+    sp--;
+    tos = value;
+    NEXT_();
+
+op_div:
+    if (tos == 0)
+        goto division_by_zero;
+
+    if (tos == -1 && sp[-1] == INT_MIN)
+        goto arithmetic_overflow;
+
+    tos = *--sp / tos;
+    NEXT_();
+
+op_mod:
+    if (tos == 0)
+        goto division_by_zero;
+
+    if (tos == -1 && sp[-1] == INT_MIN)
+        goto arithmetic_overflow;
+
+    tos = *--sp % tos;
+    NEXT_();
+
+op_neg:
+    if (__builtin_sub_overflow(0, tos, &tos))
+        goto arithmetic_overflow;
+
+    NEXT_();
+
+op_eq:
+    tos = (*--sp == tos);
+    NEXT_();
+
+op_lt:
+    tos = (*--sp < tos);
+    NEXT_();
+
+op_jmp:
+    ENTER_BLOCK_(cell->operand);
+
+op_jz:
+    value = tos;
+    tos = *--sp;
+    ENTER_BLOCK_((value == 0) ? cell->operand : cell - cells + 1);
+
+op_jnz:
+    value = tos;
+    tos = *--sp;
+    ENTER_BLOCK_((value != 0) ? cell->operand : cell - cells + 1);
+
+op_call:
+    (calls->data)[calls->size] = (TYPE_ELEMENT_STACK) (cell - cells + 1);
+
+    if ((error_code = stack_commit_open(calls, calls->size + 1, calls->size + 1, calls->size + 1, 1)) != NO_ERROR)
+        goto stack_error;
+
+    ENTER_BLOCK_(cell->operand);
+
+op_ret:
+    if (calls->size == 0)
+        goto stack_underflow;
+
+    target = (calls->data)[calls->size - 1];
+
+    if ((error_code = stack_commit_open(calls, calls->size - 1, calls->size + 1, calls->size - 1, 1)) != NO_ERROR)
+        goto stack_error;
+
+    goto enter_block;
+
+op_out:
+    if (vm->output != NULL)
+        fprintf(vm->output, FORMAT_SPECIFIERS_STACK "\n", tos);
+
+    tos = *--sp;
+    NEXT_();
+
+division_by_zero:
+    SAVE_STATE_();
+    return VM_DIVISION_BY_ZERO | error_code;
+
+arithmetic_overflow:
+    SAVE_STATE_();
+    return VM_ARITHMETIC_OVERFLOW | error_code;
+
+bad_jump_address:
+    SAVE_STATE_();
+    return VM_BAD_JUMP_ADDRESS | error_code;
+
+stack_underflow:
+    SAVE_STATE_();
+    return VM_STACK_UNDERFLOW | error_code;
+
+stack_error:
+    target = error_code;
+    SAVE_STATE_();
+    return target | error_code;
+
+    #undef DISPATCH_
+    #undef NEXT_
+    #undef SAVE_STATE_
+    #undef ENTER_BLOCK_
+}
+
+ssize_t vm_run_switch(vm_machine *vm, const vm_program *program)
+{
+    MYASSERT(vm            != NULL, NULL_POINTER_PASSED_TO_FUNC, return POINTER_TO_STACK_IS_NULL);
+    MYASSERT(program       != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program->code != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    TYPE_ELEMENT_STACK first  = 0;
+    TYPE_ELEMENT_STACK second = 0;
+
+    ssize_t pc         = 0;
+    ssize_t error_code = NO_ERROR;
+
+    #define PUSH_(value)                                                                    \
+    do {                                                                                    \
+        if ((error_code = push(vm->operands, (value))) != NO_ERROR)                         \
+            return error_code;                                                              \
+    } while(0)
+
+    #define POP_(value)                                                                     \
+    do {                                                                                    \
+        if (vm->operands->size <= 1)                                                        \
+            return VM_STACK_UNDERFLOW;                                                      \
+                                                                                            \
+        if ((error_code = pop(vm->operands, &(value))) != NO_ERROR)                         \
+            return error_code;                                                              \
+    } while(0)
+
+    while (true)
+    {
+        if (pc < 0 || pc >= program->length)
+            return VM_BAD_JUMP_ADDRESS;
+
+        const vm_instruction *instruction = program->code + pc++;
+
+        switch (instruction->opcode)
+        {
+            case VM_HLT:
+                return NO_ERROR;
+
+            case VM_PUSH:
+                PUSH_(instruction->operand);
+                break;
+
+            case VM_POP:
+                POP_(first);
+                break;
+
+            case VM_DUP:
+                POP_(first);
+                PUSH_(first);
+                PUSH_(first);
+                break;
+
+            case VM_SWAP:
+                POP_(first);
+                POP_(second);
+                PUSH_(first);
+                PUSH_(second);
+                break;
+
+            case VM_OVER:
+                POP_(first);
+                POP_(second);
+                PUSH_(second);
+                PUSH_(first);
+                PUSH_(second);
+                break;
+
+            case VM_ADD:
+                POP_(first);
+                POP_(second);
+
+                if (__builtin_add_overflow(second, first, &first))
+                    return VM_ARITHMETIC_OVERFLOW;
+
+                PUSH_(first);
+                break;
+
+            case VM_SUB:
+                POP_(first);
+                POP_(second);
+
+                if (__builtin_sub_overflow(second, first, &first))
+                    return VM_ARITHMETIC_OVERFLOW;
+
+                PUSH_(first);
+                break;
+
+            case VM_MUL:
+                POP_(first);
+                POP_(second);
+
+                if (__builtin_mul_overflow(second, first, &first))
+                    return VM_ARITHMETIC_OVERFLOW;
+
+                PUSH_(first);
+                break;
+
+            case VM_DIV:
+            case VM_MOD:
+                POP_(first);
+                POP_(second);
+
+                if (first == 0)
+                    return VM_DIVISION_BY_ZERO;
+
+                if (first == -1 && second == INT_MIN)
+                    return VM_ARITHMETIC_OVERFLOW;
+
+                PUSH_((instruction->opcode == VM_DIV) ? second / first : second % first);
+                break;
+
+            case VM_NEG:
+                POP_(first);
+
+                if (__builtin_sub_overflow(0, first, &first))
+                    return VM_ARITHMETIC_OVERFLOW;
+
+                PUSH_(first);
+                break;
+
+            case VM_EQ:
+                POP_(first);
+                POP_(second);
+                PUSH_(second == first);
+                break;
+
+            case VM_LT:
+                POP_(first);
+                POP_(second);
+                PUSH_(second < first);
+                break;
+
+            case VM_JMP:
+                pc = instruction->operand;
+                break;
+
+            case VM_JZ:
+                POP_(first);
+
+                if (first == 0)
+                    pc = instruction->operand;
+
+                break;
+
+            case VM_JNZ:
+                POP_(first);
+
+                if (first != 0)
+                    pc = instruction->operand;
+
+                break;
+
+            case VM_CALL:
+                if ((error_code = push(vm->calls, (TYPE_ELEMENT_STACK) pc)) != NO_ERROR)
+                    return error_code;
+
+                pc = instruction->operand;
+                break;
+
+            case VM_RET:
+                if (vm->calls->size == 0)
+                    return VM_STACK_UNDERFLOW;
+
+                if ((error_code = pop(vm->calls, &first)) != NO_ERROR)
+                    return error_code;
+
+                pc = first;
+                break;
+
+            case VM_OUT:
+                POP_(first);
+
+                if (vm->output != NULL)
+                    fprintf(vm->output, FORMAT_SPECIFIERS_STACK "\n", first);
+
+                break;
+
+            default:
+                return VM_UNKNOWN_OPCODE;
+        }
+    }
+
+    #undef PUSH_
+    #undef POP_
+}
+
+ssize_t assemble_pass(const char *source, vm_program *program, vm_labels *labels, bool emit, ssize_t *error_line)
+{
+    MYASSERT(source     != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(program    != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(labels     != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(error_line != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+
+    char token[VM_MAX_LABEL_LENGTH] = {};
+
+    const char *cursor  = source;
+    ssize_t     line    = 1;
+    ssize_t     address = 0;
+
+    #define SYNTAX_ERROR_()                                                                 \
+    do {                                                                                    \
+        *error_line = line;                                                                 \
+        return VM_SYNTAX_ERROR;                                                             \
+    } while(0)
+
+    while (*cursor != '\0')
+    {
+        ssize_t length = read_token(&cursor, token);
+
+        if (length < 0)
+            SYNTAX_ERROR_();
+
+        if (length == 0)
+        {
+            if (*cursor == '\n')
+            {
+                cursor++;
+                line++;
+            }
+
+            continue;
+        }
+
+        if (token[length - 1] == ':')
+        {
+            token[length - 1] = '\0';
+
+            if (!emit && (length == 1 || add_label(labels, token, address) != VM_NO_ERROR))
+                SYNTAX_ERROR_();
+
+            continue;
+        }
+
+        ssize_t opcode  = find_opcode(token);
+        int32_t operand = 0;
+
+        if (opcode < 0)
+            SYNTAX_ERROR_();
+
+        if (OPCODES_INFO[opcode].has_operand)
+        {
+            if (read_token(&cursor, token) <= 0)
+                SYNTAX_ERROR_();
+
+            if (emit && parse_operand(token, labels, (int32_t) opcode, &operand) != VM_NO_ERROR)
+                SYNTAX_ERROR_();
+        }
+
+        if (read_token(&cursor, token) != 0)
+            SYNTAX_ERROR_();
+
+        if (emit)
+        {
+            program->code[address].opcode  = (int32_t) opcode;
+            program->code[address].operand = operand;
+        }
+
+        address++;
+    }
+
+    #undef SYNTAX_ERROR_
+
+    program->length = address;
+
+    return VM_NO_ERROR;
+}
+
+ssize_t read_token(const char **cursor, char *token)
+{
+    MYASSERT(cursor  != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+    MYASSERT(*cursor != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+    MYASSERT(token   != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+
+    const char *current = *cursor;
+
+    while (*current == ' ' || *current == '\t' || *current == '\r')
+        current++;
+
+    if (*current == ';')
+        while (*current != '\n' && *current != '\0')
+            current++;
+
+    ssize_t length = 0;
+
+    while (*current != '\0' && *current != '\n' && *current != ';' &&
+           *current != ' '  && *current != '\t' && *current != '\r')
+    {
+        if (length + 1 >= VM_MAX_LABEL_LENGTH)
+            return -1;
+
+        token[length++] = *current++;
+    }
+
+    token[length] = '\0';
+    *cursor = current;
+
+    return length;
+}
+
+ssize_t find_opcode(const char *token)
+{
+    MYASSERT(token != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+
+    for (ssize_t opcode = 0; opcode < VM_OPCODES_COUNT; opcode++)
+        if (strcmp(token, OPCODES_INFO[opcode].name) == 0)
+            return opcode;
+
+    return -1;
+}
+
+ssize_t find_label(const vm_labels *labels, const char *name)
+{
+    MYASSERT(labels != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+    MYASSERT(name   != NULL, NULL_POINTER_PASSED_TO_FUNC, return -1);
+
+    for (ssize_t index = 0; index < labels->size; index++)
+        if (strcmp(labels->labels[index].name, name) == 0)
+            return labels->labels[index].address;
+
+    return -1;
+}
+
+ssize_t add_label(vm_labels *labels, const char *name, ssize_t address)
+{
+    MYASSERT(labels != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(name   != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+
+    size_t length = strlen(name);
+
+    if (length >= (size_t) VM_MAX_LABEL_LENGTH || find_label(labels, name) >= 0)
+        return VM_SYNTAX_ERROR;
+
+    if (labels->size >= labels->capacity)
+    {
+        ssize_t   capacity   = (labels->capacity > 0) ? labels->capacity * CAPACITY_MULTIPLIER : INITIAL_CAPACITY_VALUE;
+        vm_label *new_labels = (vm_label *) realloc(labels->labels, (size_t) capacity * sizeof(vm_label));
+        MYASSERT(new_labels != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return VM_SYNTAX_ERROR);
+
+        if (new_labels == NULL)
+            return VM_SYNTAX_ERROR;
+
+        labels->labels   = new_labels;
+        labels->capacity = capacity;
+    }
+
+    memcpy(labels->labels[labels->size].name, name, length + 1);
+    labels->labels[labels->size].address = address;
+
+    labels->size++;
+
+    return VM_NO_ERROR;
+}
+
+ssize_t parse_operand(const char *token, const vm_labels *labels, int32_t opcode, int32_t *operand)
+{
+    MYASSERT(token   != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(labels  != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(operand != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+
+    char *end   = NULL;
+    long  value = strtol(token, &end, 0);
+
+    if (*end == '\0' && end != token)
+    {
+        if (value < INT32_MIN || value > INT32_MAX)
+            return VM_SYNTAX_ERROR;
+
+        *operand = (int32_t) value;
+
+        return VM_NO_ERROR;
+    }
+
+    ssize_t address = find_label(labels, token);
+
+    if (!is_jump(opcode) || address < 0)
+        return VM_SYNTAX_ERROR;
+
+    *operand = (int32_t) address;
+
+    return VM_NO_ERROR;
+}
+
+ssize_t prepare_program(vm_program *program)
+{
+    MYASSERT(program       != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program->code != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    if (program->length <= 0 || program->length > INT32_MAX)
+        return VM_BAD_BYTECODE;
+
+    for (ssize_t index = 0; index < program->length; index++)
+    {
+        int32_t opcode  = program->code[index].opcode;
+        int32_t operand = program->code[index].operand;
+
+        if (opcode < 0 || opcode >= VM_OPCODES_COUNT)
+            return VM_UNKNOWN_OPCODE;
+
+        if (is_jump(opcode) && (operand < 0 || operand >= program->length))
+            return VM_BAD_JUMP_ADDRESS;
+    }
+
+    program->blocks = (vm_block *) calloc((size_t) program->length, sizeof(vm_block));
+    MYASSERT(program->blocks != NULL, FAILED_TO_ALLOCATE_DYNAM_MEMOR, return VM_BAD_BYTECODE);
+
+    if (program->blocks == NULL)
+        return VM_BAD_BYTECODE;
+
+    ssize_t error_code = analyze_block(program, 0);
+
+    for (ssize_t index = 0; index < program->length && error_code == VM_NO_ERROR; index++)
+    {
+        int32_t opcode = program->code[index].opcode;
+
+        if (is_jump(opcode))
+            error_code = analyze_block(program, program->code[index].operand);
+
+        if (error_code == VM_NO_ERROR && (opcode == VM_JZ || opcode == VM_JNZ || opcode == VM_CALL))
+            error_code = analyze_block(program, index + 1);
+    }
+
+    return error_code;
+}
+
+ssize_t analyze_block(vm_program *program, ssize_t entry)
+{
+    MYASSERT(program         != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(program->blocks != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    ssize_t depth  = 0;
+    ssize_t need   = 0;
+    ssize_t growth = 0;
+
+    for (ssize_t index = entry; index < program->length; index++)
+    {
+        const vm_opcode_info *info = OPCODES_INFO + program->code[index].opcode;
+
+        depth -= info->pops;
+
+        if (-depth > need)
+            need = -depth;
+
+        depth += info->pushes;
+
+        if (depth > growth)
+            growth = depth;
+
+        if (is_block_end(program->code[index].opcode))
+        {
+            program->blocks[entry].need   = need;
+            program->blocks[entry].growth = growth;
+
+            return VM_NO_ERROR;
+        }
+    }
+
+    return VM_BAD_BYTECODE;
+}
+
+bool is_jump(int32_t opcode)
+{
+    return opcode == VM_JMP || opcode == VM_JZ || opcode == VM_JNZ || opcode == VM_CALL;
+}
+
+bool is_block_end(int32_t opcode)
+{
+    return is_jump(opcode) || opcode == VM_RET || opcode == VM_HLT;
+}
@@ -0,0 +1,151 @@
+#include "vm.h"
+#include "myassert.h"
+#include <time.h>
+
+const char SUM_PROGRAM[] =
+    "        push %ld        \n"
+    "        push 0          \n"
+    "loop:                   \n"
+    "        over            \n"
+    "        add             \n"
+    "        push 1000003    \n"
+    "        mod             \n"
+    "        swap            \n"
+    "        push 1          \n"
+    "        sub             \n"
+    "        dup             \n"
+    "        jz done         \n"
+    "        swap            \n"
+    "        jmp loop        \n"
+    "done:                   \n"
+    "        pop             \n"
+    "        hlt             \n";
+
+const char FIB_PROGRAM[] =
+    "        push %ld        \n"
+    "        call fib        \n"
+    "        hlt             \n"
+    "fib:                    \n"
+    "        dup             \n"
+    "        push 2          \n"
+    "        lt              \n"
+    "        jnz fib_base    \n"
+    "        dup             \n"
+    "        push 1          \n"
+    "        sub             \n"
+    "        call fib        \n"
+    "        swap            \n"
+    "        push 2          \n"
+    "        sub             \n"
+    "        call fib        \n"
+    "        add             \n"
+    "        ret             \n"
+    "fib_base:               \n"
+    "        ret             \n";
+
+const long DEFAULT_SUM_ITERATIONS = 10000000;
+const long DEFAULT_FIB_ARGUMENT   = 27;
+
+typedef ssize_t (*vm_runner)(vm_machine *vm, vm_program *program);
+
+static ssize_t run_switch(vm_machine *vm, vm_program *program);
+static ssize_t benchmark(const char *name, const char *source_format, long argument);
+static ssize_t measure(vm_program *program, vm_runner runner, double *seconds, TYPE_ELEMENT_STACK *result);
+static double get_time();
+
+int main(int argc, const char *argv[])
+{
+    long sum_iterations = (argc > 1) ? strtol(argv[1], NULL, 10) : DEFAULT_SUM_ITERATIONS;
+    long fib_argument   = (argc > 2) ? strtol(argv[2], NULL, 10) : DEFAULT_FIB_ARGUMENT;
+
+    ssize_t error_code = benchmark("sum", SUM_PROGRAM, sum_iterations) |
+                         benchmark("fib", FIB_PROGRAM, fib_argument);
+
+    return (error_code == VM_NO_ERROR) ? 0 : 1;
+}
+
+ssize_t run_switch(vm_machine *vm, vm_program *program)
+{
+    return vm_run_switch(vm, program);
+}
+
+ssize_t benchmark(const char *name, const char *source_format, long argument)
+{
+    MYASSERT(name          != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+    MYASSERT(source_format != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_SYNTAX_ERROR);
+
+    char source[sizeof(FIB_PROGRAM) + sizeof(SUM_PROGRAM)] = {};
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    snprintf(source, sizeof(source), source_format, argument);
+    #pragma GCC diagnostic pop
+
+    vm_program program    = {};
+    ssize_t    error_line = 0;
+    ssize_t    error_code = vm_assemble(source, &program, &error_line);
+
+    if (error_code != VM_NO_ERROR)
+    {
+        printf("%s: syntax error in line %ld\n", name, error_line);
+        return error_code;
+    }
+
+    double             switch_time     = 0;
+    double             threaded_time   = 0;
+    TYPE_ELEMENT_STACK switch_result   = 0;
+    TYPE_ELEMENT_STACK threaded_result = 0;
+
+    error_code = measure(&program, run_switch, &switch_time,   &switch_result) |
+                 measure(&program, vm_run,     &threaded_time, &threaded_result);
+
+    vm_program_destructor(&program);
+
+    if (error_code != NO_ERROR || switch_result != threaded_result)
+    {
+        printf("%s(%ld): failed, error code %ld\n", name, argument, error_code);
+        return error_code | VM_BAD_BYTECODE;
+    }
+
+    printf("%s(%ld) = " FORMAT_SPECIFIERS_STACK "\n", name, argument, threaded_result);
+    printf("\tswitch:   %.3lf s\n", switch_time);
+    printf("\tthreaded: %.3lf s\n", threaded_time);
+    printf("\tspeedup:  %.2lfx\n",  switch_time / threaded_time);
+
+    return VM_NO_ERROR;
+}
+
+ssize_t measure(vm_program *program, vm_runner runner, double *seconds, TYPE_ELEMENT_STACK *result)
+{
+    MYASSERT(program != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(runner  != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(seconds != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+    MYASSERT(result  != NULL, NULL_POINTER_PASSED_TO_FUNC, return VM_BAD_BYTECODE);
+
+    vm_machine vm = {};
+
+    ssize_t error_code = vm_constructor(&vm, NULL);
+
+    if (error_code != NO_ERROR)
+        return error_code;
+
+    double start = get_time();
+
+    error_code = runner(&vm, program);
+
+    *seconds = get_time() - start;
+
+    if (error_code == NO_ERROR)
+        error_code = vm_pop_result(&vm, result);
+
+    return error_code | vm_destructor(&vm);
+}
+
+double get_time()
+{
+    timespec now = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
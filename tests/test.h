@@ -0,0 +1,20 @@
+#ifndef TEST_H_INCLUDED
+#define TEST_H_INCLUDED
+
+#include <stdio.h>
+
+static int Test_failures = 0;
+
+#define TEST_CHECK(condition)                                                           \
+do {                                                                                    \
+    if (!(condition))                                                                   \
+    {                                                                                   \
+        fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition);  \
+        Test_failures++;                                                                \
+    }                                                                                   \
+} while(0)
+
+#define TEST_RESULT()                                                                   \
+    ((Test_failures == 0) ? (printf("ok\n"), 0) : (printf("%d failed\n", Test_failures), 1))
+
+#endif  //TEST_H_INCLUDED
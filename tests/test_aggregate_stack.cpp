@@ -0,0 +1,87 @@
+#include "aggregate_stack.h"
+#include "test.h"
+
+const int ELEMENTS_COUNT = 100;
+
+static aggregate_t combine_xor(aggregate_t left, aggregate_t right);
+static void        check_aggregates(const aggregate_stack *astk, ssize_t xor_index, const TYPE_ELEMENT_STACK *values, int count);
+
+int main()
+{
+    aggregate_stack astk = {};
+
+    TEST_CHECK(aggregate_stack_constructor(&astk) == NO_ERROR);
+
+    aggregate_t result = 0;
+
+    TEST_CHECK(stack_min(&astk, &result) == SIZE_NULL_IN_POP);
+    TEST_CHECK(stack_max(&astk, &result) == SIZE_NULL_IN_POP);
+    TEST_CHECK(stack_sum(&astk, &result) == SIZE_NULL_IN_POP);
+
+    TYPE_ELEMENT_STACK values[ELEMENTS_COUNT] = {};
+
+    for (int index = 0; index < ELEMENTS_COUNT; index++)
+        values[index] = (index * 37) % 101 - 50;
+
+    for (int index = 0; index < ELEMENTS_COUNT / 2; index++)
+        TEST_CHECK(aggregate_push(&astk, values[index]) == NO_ERROR);
+
+    ssize_t xor_index = 0;
+
+    TEST_CHECK(aggregate_stack_add(&astk, combine_xor, &xor_index) == NO_ERROR && xor_index == AGGREGATE_BUILTIN_COUNT);
+
+    TEST_CHECK(aggregate_push_bulk(&astk, values + ELEMENTS_COUNT / 2, ELEMENTS_COUNT / 2) == NO_ERROR);
+    TEST_CHECK(astk.levels_capacity >= ELEMENTS_COUNT);
+
+    check_aggregates(&astk, xor_index, values, ELEMENTS_COUNT);
+
+    TEST_CHECK(aggregate_pop_bulk(&astk, ELEMENTS_COUNT - 10) == NO_ERROR);
+
+    check_aggregates(&astk, xor_index, values, 10);
+
+    TEST_CHECK(astk.levels_capacity < ELEMENTS_COUNT);
+    TEST_CHECK(aggregate_pop_bulk(&astk, 11) == SIZE_NULL_IN_POP);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    for (int count = 10; count > 0; count--)
+    {
+        TEST_CHECK(aggregate_pop(&astk, &value) == NO_ERROR && value == values[count - 1]);
+
+        if (count > 1)
+            check_aggregates(&astk, xor_index, values, count - 1);
+    }
+
+    TEST_CHECK(stack_sum(&astk, &result) == SIZE_NULL_IN_POP);
+    TEST_CHECK(aggregate_stack_destructor(&astk) == NO_ERROR);
+
+    return TEST_RESULT();
+}
+
+aggregate_t combine_xor(aggregate_t left, aggregate_t right)
+{
+    return left ^ right;
+}
+
+void check_aggregates(const aggregate_stack *astk, ssize_t xor_index, const TYPE_ELEMENT_STACK *values, int count)
+{
+    aggregate_t min     = values[0];
+    aggregate_t max     = values[0];
+    aggregate_t sum     = values[0];
+    aggregate_t xor_sum = values[0];
+
+    for (int index = 1; index < count; index++)
+    {
+        min      = (values[index] < min) ? values[index] : min;
+        max      = (values[index] > max) ? values[index] : max;
+        sum     += values[index];
+        xor_sum ^= values[index];
+    }
+
+    aggregate_t result = 0;
+
+    TEST_CHECK(stack_min(astk, &result) == NO_ERROR && result == min);
+    TEST_CHECK(stack_max(astk, &result) == NO_ERROR && result == max);
+    TEST_CHECK(stack_sum(astk, &result) == NO_ERROR && result == sum);
+    TEST_CHECK(stack_aggregate(astk, xor_index, &result) == NO_ERROR && result == xor_sum);
+}
@@ -0,0 +1,91 @@
+#include "blocking_stack.h"
+#include "test.h"
+
+const int  ITEMS_COUNT = 2000;
+const long BOUND       = 16;
+
+static void *producer_routine(void *argument);
+
+int main()
+{
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    blocking_stack bstk = {};
+
+    TEST_CHECK(blocking_stack_constructor(&bstk, stk, BOUND) == NO_ERROR);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(try_pop(&bstk, &value)      == SIZE_NULL_IN_POP);
+    TEST_CHECK(pop_wait(&bstk, &value, 20) == WAIT_TIMED_OUT);
+
+    for (int index = 0; index < BOUND; index++)
+        TEST_CHECK(try_push(&bstk, index) == NO_ERROR);
+
+    TEST_CHECK(try_push(&bstk, -1)      == STACK_IS_FULL);
+    TEST_CHECK(push_wait(&bstk, -1, 20) == WAIT_TIMED_OUT);
+
+    for (int index = BOUND - 1; index >= 0; index--)
+        TEST_CHECK(try_pop(&bstk, &value) == NO_ERROR && value == index);
+
+    // A batch that times out partway reports how much of it made it, so the caller can push exactly the rest.
+    TYPE_ELEMENT_STACK batch[BOUND] = {};
+
+    for (int index = 0; index < BOUND; index++)
+        batch[index] = 100 + index;
+
+    for (int index = 0; index < BOUND - 5; index++)
+        TEST_CHECK(try_push(&bstk, index) == NO_ERROR);
+
+    ssize_t pushed = -1;
+
+    TEST_CHECK(push_batch_wait(&bstk, batch, BOUND, 20, &pushed) == WAIT_TIMED_OUT && pushed == 5);
+    TEST_CHECK(stk->size == BOUND);
+
+    for (int index = 4; index >= 0; index--)
+        TEST_CHECK(try_pop(&bstk, &value) == NO_ERROR && value == 100 + index);
+
+    for (int index = BOUND - 6; index >= 0; index--)
+        TEST_CHECK(try_pop(&bstk, &value) == NO_ERROR && value == index);
+
+    pthread_t producer = {};
+
+    TEST_CHECK(pthread_create(&producer, NULL, producer_routine, &bstk) == 0);
+
+    long long sum = 0;
+
+    for (int index = 0; index < ITEMS_COUNT; index++)
+    {
+        TEST_CHECK(pop_wait(&bstk, &value, WAIT_FOREVER) == NO_ERROR);
+        sum += value;
+    }
+
+    pthread_join(producer, NULL);
+
+    TEST_CHECK(sum == (long long) ITEMS_COUNT * (ITEMS_COUNT - 1) / 2);
+    TEST_CHECK(try_pop(&bstk, &value) == SIZE_NULL_IN_POP);
+
+    TEST_CHECK(blocking_stack_destructor(&bstk) == NO_ERROR);
+
+    return TEST_RESULT();
+}
+
+void *producer_routine(void *argument)
+{
+    blocking_stack *bstk = (blocking_stack *) argument;
+
+    TYPE_ELEMENT_STACK batch[8] = {};
+
+    for (int value = 0; value < ITEMS_COUNT; value += 8)
+    {
+        for (int index = 0; index < 8; index++)
+            batch[index] = value + index;
+
+        ssize_t pushed = 0;
+
+        TEST_CHECK(push_batch_wait(bstk, batch, 8, WAIT_FOREVER, &pushed) == NO_ERROR && pushed == 8);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,84 @@
+#include "compressed_stack.h"
+#include "test.h"
+
+const ssize_t ELEMENTS_COUNT = 3 * COMPRESSED_BLOCK_LENGTH + 100;
+
+static TYPE_ELEMENT_STACK element(ssize_t index);
+static void check_runs_ratio();
+
+int main()
+{
+    compressed_stack cstk = {};
+
+    TEST_CHECK(compressed_stack_constructor(&cstk) == NO_ERROR);
+
+    for (ssize_t index = 0; index < ELEMENTS_COUNT; index++)
+        TEST_CHECK(compressed_push(&cstk, element(index)) == NO_ERROR);
+
+    compressed_statistics statistics = {};
+
+    TEST_CHECK(compressed_stack_statistics(&cstk, &statistics) == NO_ERROR);
+    TEST_CHECK(statistics.size == ELEMENTS_COUNT && statistics.cold_elements > 0);
+    TEST_CHECK(verify_compressed_stack(&cstk) == NO_ERROR);
+
+    // The hot stack is checked through its own verification, not as a side effect of another call.
+    ssize_t size = cstk.hot->size;
+
+    cstk.hot->size = cstk.hot->capacity + 1;
+
+    TEST_CHECK(verify_compressed_stack(&cstk) & SIZE_MORE_THAN_CAPACITY);
+
+    cstk.hot->size       = size;
+    cstk.hot->error_code = NO_ERROR;
+
+    cstk.blocks[0].bytes[0] ^= 1;
+
+    TEST_CHECK(verify_compressed_stack(&cstk) == COMPRESSED_BLOCK_DAMAGED);
+
+    cstk.blocks[0].bytes[0] ^= 1;
+
+    TEST_CHECK(verify_compressed_stack(&cstk) == NO_ERROR);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    for (ssize_t index = ELEMENTS_COUNT - 1; index >= 0; index--)
+        TEST_CHECK(compressed_pop(&cstk, &value) == NO_ERROR && value == element(index));
+
+    TEST_CHECK(compressed_pop(&cstk, &value) == SIZE_NULL_IN_POP);
+    TEST_CHECK(compressed_stack_destructor(&cstk) == NO_ERROR);
+
+    check_runs_ratio();
+
+    return TEST_RESULT();
+}
+
+TYPE_ELEMENT_STACK element(ssize_t index)
+{
+    return (TYPE_ELEMENT_STACK) ((index % 7 == 0) ? -index * 1000 : index);
+}
+
+// A monotone and a constant sequence are runs of one difference each, so they shrink far past a byte per element.
+void check_runs_ratio()
+{
+    const ssize_t MAX_BYTES_PER_BLOCK = 16;
+
+    for (int step = 0; step <= 3; step++)
+    {
+        compressed_stack cstk = {};
+
+        TEST_CHECK(compressed_stack_constructor(&cstk) == NO_ERROR);
+
+        for (ssize_t index = 0; index < ELEMENTS_COUNT; index++)
+            TEST_CHECK(compressed_push(&cstk, (TYPE_ELEMENT_STACK) (7 + step * index)) == NO_ERROR);
+
+        TEST_CHECK(cstk.blocks_count > 0);
+        TEST_CHECK(cstk.compressed_bytes <= cstk.blocks_count * MAX_BYTES_PER_BLOCK);
+
+        TYPE_ELEMENT_STACK value = 0;
+
+        for (ssize_t index = ELEMENTS_COUNT - 1; index >= 0; index--)
+            TEST_CHECK(compressed_pop(&cstk, &value) == NO_ERROR && value == 7 + step * index);
+
+        TEST_CHECK(compressed_stack_destructor(&cstk) == NO_ERROR);
+    }
+}
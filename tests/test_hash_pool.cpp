@@ -0,0 +1,62 @@
+#include "hash_pool.h"
+#include "test.h"
+
+const ssize_t CHUNKS_COUNT = 150;
+const ssize_t BUFFER_SIZE  = CHUNKS_COUNT * HASH_CHUNK_SIZE + 123;
+const uint32_t SEED        = 0xDED;
+
+static uint32_t reference_hash(const char *array, ssize_t size, uint32_t seed);
+
+int main()
+{
+    char *buffer = (char *) calloc((size_t) BUFFER_SIZE, 1);
+
+    TEST_CHECK(buffer != NULL);
+
+    uint32_t state = 1;
+
+    for (ssize_t index = 0; index < BUFFER_SIZE; index++)
+    {
+        state         = state * 1103515245 + 12345;
+        buffer[index] = (char) (state >> 16);
+    }
+
+    const ssize_t SIZES[]         = {0, 100, HASH_CHUNK_SIZE, 3 * HASH_CHUNK_SIZE + 1, BUFFER_SIZE};
+    const ssize_t THREAD_COUNTS[] = {1, 2, 4, 8};
+
+    // More chunks than one local batch hold, and every thread count has to land on the same hash.
+    for (size_t threads = 0; threads < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); threads++)
+    {
+        TEST_CHECK(hash_pool_set_threads(THREAD_COUNTS[threads]) == NO_ERROR);
+        TEST_CHECK(hash_pool_get_threads() == THREAD_COUNTS[threads]);
+
+        for (size_t index = 0; index < sizeof(SIZES) / sizeof(SIZES[0]); index++)
+            TEST_CHECK(hash_chunked(buffer, SIZES[index], SEED) == reference_hash(buffer, SIZES[index], SEED));
+    }
+
+    TEST_CHECK(hash_pool_set_threads(0) == NO_ERROR);
+
+    free(buffer);
+
+    return TEST_RESULT();
+}
+
+uint32_t reference_hash(const char *array, ssize_t size, uint32_t seed)
+{
+    ssize_t   chunks_count = (size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+    uint32_t *hashes       = (uint32_t *) calloc((size_t) chunks_count + 1, sizeof(uint32_t));
+
+    for (ssize_t chunk = 0; chunk < chunks_count; chunk++)
+    {
+        ssize_t begin  = chunk * HASH_CHUNK_SIZE;
+        ssize_t length = (size - begin < HASH_CHUNK_SIZE) ? size - begin : HASH_CHUNK_SIZE;
+
+        hashes[chunk] = hash_buffer(array + begin, length, seed + (uint32_t) chunk);
+    }
+
+    uint32_t hash = hash_buffer(hashes, chunks_count * (ssize_t) sizeof(uint32_t), seed);
+
+    free(hashes);
+
+    return hash;
+}
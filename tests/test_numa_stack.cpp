@@ -0,0 +1,144 @@
+#include "numa_stack.h"
+#include "test.h"
+
+const ssize_t CPUS_COUNT  = 8;
+const int     ITERATIONS  = 2000;
+
+static void  check_simulated_topology();
+static void  check_constructor_node();
+static void  check_pool();
+static void *setter_routine(void *argument);
+
+int main()
+{
+    check_simulated_topology();
+    check_constructor_node();
+    check_pool();
+
+    TEST_CHECK(numa_reset_topology() == NO_ERROR);
+
+    return TEST_RESULT();
+}
+
+void check_simulated_topology()
+{
+    const int CPU_TO_NODE[CPUS_COUNT] = {0, 0, 1, 1, 2, 2, 3, 3};
+
+    TEST_CHECK(numa_set_simulated_topology(CPU_TO_NODE, CPUS_COUNT) == NO_ERROR);
+
+    numa_topology topology = {};
+
+    TEST_CHECK(numa_get_topology(&topology) == NO_ERROR);
+
+    TEST_CHECK(topology.is_simulated);
+    TEST_CHECK(topology.cpus_count  == CPUS_COUNT);
+    TEST_CHECK(topology.nodes_count == 4);
+
+    for (ssize_t cpu = 0; cpu < CPUS_COUNT; cpu++)
+        TEST_CHECK(topology.cpu_to_node[cpu] == CPU_TO_NODE[cpu]);
+
+    const int BAD_CPU_TO_NODE[CPUS_COUNT] = {0, 0, 1, NUMA_MAX_NODES, 2, 2, 3, 3};
+
+    TEST_CHECK(numa_set_simulated_topology(BAD_CPU_TO_NODE, CPUS_COUNT) == SIZE_MORE_THAN_CAPACITY);
+    TEST_CHECK(numa_get_topology(&topology) == NO_ERROR && topology.nodes_count == 4);
+
+    TEST_CHECK(numa_simulate_thread_node(2) == NO_ERROR);
+    TEST_CHECK(numa_current_node() == 2);
+    TEST_CHECK(numa_simulate_thread_node(NUMA_NODE_ANY) == NO_ERROR);
+
+    // Every copy has to be one whole topology, never a mix of the two the setter alternates between.
+    const int UNIFORM_CPU_TO_NODE[CPUS_COUNT] = {};
+
+    TEST_CHECK(numa_set_simulated_topology(UNIFORM_CPU_TO_NODE, CPUS_COUNT) == NO_ERROR);
+
+    pthread_t setter = {};
+
+    TEST_CHECK(pthread_create(&setter, NULL, setter_routine, NULL) == 0);
+
+    for (int iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        numa_get_topology(&topology);
+
+        for (ssize_t cpu = 0; cpu < topology.cpus_count; cpu++)
+            TEST_CHECK(topology.cpu_to_node[cpu] == topology.nodes_count - 1);
+    }
+
+    pthread_join(setter, NULL);
+}
+
+void *setter_routine(void *argument)
+{
+    (void) argument;
+
+    int cpu_to_node[CPUS_COUNT] = {};
+
+    for (int iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        for (ssize_t cpu = 0; cpu < CPUS_COUNT; cpu++)
+            cpu_to_node[cpu] = iteration % 2;
+
+        TEST_CHECK(numa_set_simulated_topology(cpu_to_node, CPUS_COUNT) == NO_ERROR);
+    }
+
+    return NULL;
+}
+
+// A stack whose memory came zeroed must not end up bound to node 0.
+void check_constructor_node()
+{
+    stack *stk = get_pointer_stack();
+
+    stk->numa_node = 0;
+
+    STACK_CONSTRUCTOR(stk);
+
+    TEST_CHECK(stk->numa_node == NUMA_NODE_ANY);
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    stk = get_pointer_stack();
+
+    STACK_CONSTRUCTOR_ON_NODE(stk, 3);
+
+    TEST_CHECK(stk->numa_node == 3);
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    Global_numa_policy = NUMA_POLICY_EXPLICIT;
+    Global_numa_node   = 1;
+
+    stk = get_pointer_stack();
+
+    STACK_CONSTRUCTOR(stk);
+
+    #ifdef NUMA_BIND_INCLUDED
+        TEST_CHECK(stk->numa_node == 1);
+    #else
+        TEST_CHECK(stk->numa_node == NUMA_NODE_ANY);
+    #endif
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    Global_numa_policy = NUMA_POLICY_DEFAULT;
+    Global_numa_node   = 0;
+}
+
+void check_pool()
+{
+    numa_stack_pool pool = {};
+
+    TEST_CHECK(numa_pool_constructor(&pool) == NO_ERROR);
+    TEST_CHECK(numa_simulate_thread_node(1) == NO_ERROR);
+
+    stack *stk = numa_pool_get(&pool);
+
+    TEST_CHECK(stk != NULL && stk->numa_node == 1);
+    TEST_CHECK(push(stk, 7) == NO_ERROR);
+    TEST_CHECK(numa_pool_put(&pool, stk) == NO_ERROR);
+
+    stack *reused = numa_pool_get(&pool);
+
+    TEST_CHECK(reused == stk && reused->size == 0);
+    TEST_CHECK(numa_pool_put(&pool, reused) == NO_ERROR);
+
+    TEST_CHECK(numa_simulate_thread_node(NUMA_NODE_ANY) == NO_ERROR);
+    TEST_CHECK(numa_pool_destructor(&pool) == NO_ERROR);
+}
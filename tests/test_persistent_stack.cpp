@@ -0,0 +1,141 @@
+#include "persistent_stack.h"
+#include "test.h"
+#include <pthread.h>
+
+const int THREADS_COUNT = 4;
+const int ROUNDS_COUNT  = 20000;
+
+static void  check_threads();
+static void *worker_routine(void *argument);
+
+int main()
+{
+    persistent_stack base = persistent_stack_empty();
+
+    for (int value = 1; value <= 1000; value++)
+    {
+        persistent_stack next = {};
+
+        TEST_CHECK(persistent_push(&base, value, &next) == NO_ERROR);
+        TEST_CHECK(persistent_stack_release(&base) == NO_ERROR);
+
+        base = next;
+    }
+
+    TEST_CHECK(base.size == 1000);
+
+    persistent_stack fork = persistent_stack_fork(&base);
+
+    persistent_stack left  = {};
+    persistent_stack right = {};
+
+    TEST_CHECK(persistent_push(&base, -1, &left)  == NO_ERROR);
+    TEST_CHECK(persistent_push(&base, -2, &right) == NO_ERROR);
+
+    TEST_CHECK(left.top->next == right.top->next);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(persistent_top(&left,  &value) == NO_ERROR && value == -1);
+    TEST_CHECK(persistent_top(&right, &value) == NO_ERROR && value == -2);
+
+    persistent_stack popped = {};
+
+    TEST_CHECK(persistent_pop(&left, &value, &popped) == NO_ERROR && value == -1);
+    TEST_CHECK(popped.top == base.top && popped.size == 1000);
+
+    TEST_CHECK(persistent_stack_release(&left) == NO_ERROR);
+    TEST_CHECK(persistent_top(&right, &value) == NO_ERROR && value == -2);
+
+    for (int expected = 1000; expected >= 1; expected--)
+    {
+        persistent_stack next = {};
+
+        TEST_CHECK(persistent_pop(&fork, &value, &next) == NO_ERROR && value == expected);
+        TEST_CHECK(persistent_stack_release(&fork) == NO_ERROR);
+
+        fork = next;
+    }
+
+    TEST_CHECK(persistent_pop(&fork, &value, &popped) == SIZE_NULL_IN_POP);
+
+    TEST_CHECK(persistent_top(&base, &value) == NO_ERROR && value == 1000);
+
+    TEST_CHECK(persistent_pool_destructor() == POOL_STILL_IN_USE);
+
+    persistent_stack_release(&base);
+    persistent_stack_release(&right);
+    persistent_stack_release(&popped);
+
+    TEST_CHECK(persistent_pool_destructor() == NO_ERROR);
+
+    check_threads();
+
+    return TEST_RESULT();
+}
+
+// Threads that each own their versions share one pool and one tail; the pool must come back whole.
+void check_threads()
+{
+    persistent_stack base = persistent_stack_empty();
+
+    for (int value = 1; value <= 100; value++)
+    {
+        persistent_stack next = {};
+
+        TEST_CHECK(persistent_push(&base, value, &next) == NO_ERROR);
+        TEST_CHECK(persistent_stack_release(&base) == NO_ERROR);
+
+        base = next;
+    }
+
+    pthread_t threads[THREADS_COUNT] = {};
+
+    for (int index = 0; index < THREADS_COUNT; index++)
+        TEST_CHECK(pthread_create(threads + index, NULL, worker_routine, &base) == 0);
+
+    for (int index = 0; index < THREADS_COUNT; index++)
+        pthread_join(threads[index], NULL);
+
+    TEST_CHECK(base.top->ref_count == 1);
+    TEST_CHECK(persistent_stack_release(&base) == NO_ERROR);
+    TEST_CHECK(persistent_pool_destructor() == NO_ERROR);
+}
+
+void *worker_routine(void *argument)
+{
+    const persistent_stack *base = (const persistent_stack *) argument;
+
+    for (int round = 0; round < ROUNDS_COUNT; round++)
+    {
+        persistent_stack version = persistent_stack_fork(base);
+
+        for (int value = 0; value < 8; value++)
+        {
+            persistent_stack next = {};
+
+            TEST_CHECK(persistent_push(&version, round + value, &next) == NO_ERROR);
+            TEST_CHECK(persistent_stack_release(&version) == NO_ERROR);
+
+            version = next;
+        }
+
+        TYPE_ELEMENT_STACK value = 0;
+
+        for (int expected = 7; expected >= -1; expected--)
+        {
+            persistent_stack next = {};
+
+            TEST_CHECK(persistent_pop(&version, &value, &next) == NO_ERROR);
+            TEST_CHECK(value == ((expected >= 0) ? round + expected : 100));
+            TEST_CHECK(persistent_stack_release(&version) == NO_ERROR);
+
+            version = next;
+        }
+
+        TEST_CHECK(version.size == 99);
+        TEST_CHECK(persistent_stack_release(&version) == NO_ERROR);
+    }
+
+    return NULL;
+}
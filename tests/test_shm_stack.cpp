@@ -0,0 +1,156 @@
+#include "shm_stack.h"
+#include "test.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+static void check_swapped_canaries(shm_stack *stk, shm_stack *peer);
+static void check_owner_death(const char *name);
+static void check_torn_segment(const char *name);
+static void die_holding_lock(const char *name, bool tear_header);
+
+int main()
+{
+    char name[64] = {};
+
+    snprintf(name, sizeof(name), "/stack_test_%ld", (long) getpid());
+
+    shm_stack stk  = {};
+    shm_stack peer = {};
+
+    TEST_CHECK(shm_stack_constructor(&stk, name, 16) == NO_ERROR);
+    TEST_CHECK(shm_stack_constructor(&peer, name, 16) == BAD_SHARED_SEGMENT);
+    TEST_CHECK(shm_stack_attach(&peer, name) == NO_ERROR);
+
+    for (int value = 0; value < 16; value++)
+        TEST_CHECK(shm_push(&stk, value) == NO_ERROR);
+
+    TEST_CHECK(shm_push(&peer, 16) == STACK_IS_FULL);
+
+    TYPE_ELEMENT_STACK value = 0;
+    ssize_t            size  = 0;
+
+    TEST_CHECK(shm_pop(&peer, &value) == NO_ERROR && value == 15);
+    TEST_CHECK(shm_stack_size(&stk, &size) == NO_ERROR && size == 15);
+
+    check_swapped_canaries(&stk, &peer);
+
+    TEST_CHECK(shm_stack_detach(&peer) == NO_ERROR);
+    TEST_CHECK(shm_stack_destructor(&stk) == NO_ERROR);
+
+    check_owner_death(name);
+    check_torn_segment(name);
+
+    return TEST_RESULT();
+}
+
+// Each canary has its own value, so one copied over another is damage and not a match.
+void check_swapped_canaries(shm_stack *stk, shm_stack *peer)
+{
+    shm_stack_header *header = stk->header;
+
+    uint64_t right_canary = header->right_canary;
+
+    header->right_canary = header->left_canary;
+
+    TEST_CHECK(verify_shm_stack(peer) == BAD_SHARED_SEGMENT);
+
+    header->right_canary = right_canary;
+
+    TEST_CHECK(verify_shm_stack(peer) == NO_ERROR);
+
+    uint64_t *left_data_canary  = (uint64_t *) ((char *) header + header->state.data_offset - sizeof(uint64_t));
+    uint64_t *right_data_canary = (uint64_t *) ((char *) header + header->state.segment_size - sizeof(uint64_t));
+
+    right_canary = *right_data_canary;
+
+    *right_data_canary = *left_data_canary;
+
+    TEST_CHECK(verify_shm_stack(peer) == BAD_SHARED_SEGMENT);
+
+    *right_data_canary = right_canary;
+
+    TEST_CHECK(*left_data_canary != header->left_canary && *right_data_canary != header->right_canary);
+    TEST_CHECK(verify_shm_stack(peer) == NO_ERROR);
+}
+
+// A peer that dies holding the lock mid-push leaves the old stack, which the next locker recovers.
+void check_owner_death(const char *name)
+{
+    shm_stack stk = {};
+
+    TEST_CHECK(shm_stack_constructor(&stk, name, 16) == NO_ERROR);
+
+    for (int value = 0; value < 4; value++)
+        TEST_CHECK(shm_push(&stk, value) == NO_ERROR);
+
+    die_holding_lock(name, false);
+
+    ssize_t size = 0;
+
+    TEST_CHECK(shm_stack_size(&stk, &size) == NO_ERROR && size == 4);
+    TEST_CHECK(stk.header->recoveries == 1);
+    TEST_CHECK(verify_shm_stack(&stk) == NO_ERROR);
+
+    TEST_CHECK(shm_push(&stk, 4) == NO_ERROR);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    for (int expected = 4; expected >= 0; expected--)
+        TEST_CHECK(shm_pop(&stk, &value) == NO_ERROR && value == expected);
+
+    TEST_CHECK(shm_pop(&stk, &value) == SIZE_NULL_IN_POP);
+    TEST_CHECK(stk.header->recoveries == 1);
+    TEST_CHECK(shm_stack_destructor(&stk) == NO_ERROR);
+}
+
+// A peer that dies with the header torn leaves a segment nobody may recover.
+void check_torn_segment(const char *name)
+{
+    shm_stack stk = {};
+
+    TEST_CHECK(shm_stack_constructor(&stk, name, 16) == NO_ERROR);
+    TEST_CHECK(shm_push(&stk, 1) == NO_ERROR);
+
+    die_holding_lock(name, true);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(shm_pop(&stk, &value) & BAD_SHARED_SEGMENT);
+    TEST_CHECK(stk.header->recoveries == 0);
+
+    TEST_CHECK(shm_push(&stk, 2)       == BAD_SHARED_SEGMENT);
+    TEST_CHECK(verify_shm_stack(&stk)  == BAD_SHARED_SEGMENT);
+    TEST_CHECK(stk.header->recoveries == 0);
+
+    TEST_CHECK(shm_stack_destructor(&stk) == NO_ERROR);
+}
+
+void die_holding_lock(const char *name, bool tear_header)
+{
+    pid_t child = fork();
+
+    TEST_CHECK(child >= 0);
+
+    if (child == 0)
+    {
+        shm_stack peer = {};
+
+        if (shm_stack_attach(&peer, name) != NO_ERROR || pthread_mutex_lock(&peer.header->lock) != 0)
+            _exit(1);
+
+        shm_stack_header *header = peer.header;
+
+        // Half a push: the element is stored, size is not, and then the peer is gone.
+        ((TYPE_ELEMENT_STACK *) ((char *) header + header->state.data_offset))[header->state.size] = 99;
+
+        if (tear_header)
+            header->state.size = header->state.capacity + 1;
+
+        _exit(0);
+    }
+
+    int status = 0;
+
+    TEST_CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
@@ -0,0 +1,88 @@
+#include "spill_stack.h"
+#include "test.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+const ssize_t MEMORY_BUDGET  = 256;
+const ssize_t ELEMENTS_COUNT = 1000;
+
+static void check_existing_path();
+
+int main()
+{
+    check_existing_path();
+
+    char file_name[] = "/tmp/spill_stack_XXXXXX";
+
+    int descriptor = mkstemp(file_name);
+
+    TEST_CHECK(descriptor >= 0);
+
+    close(descriptor);
+    unlink(file_name);
+
+    spill_stack sstk = {};
+
+    TEST_CHECK(spill_stack_constructor(&sstk, file_name, MEMORY_BUDGET) == NO_ERROR);
+    TEST_CHECK(access(file_name, F_OK) != 0);
+
+    for (int value = 0; value < ELEMENTS_COUNT; value++)
+        TEST_CHECK(spill_push(&sstk, value) == NO_ERROR);
+
+    ssize_t size = 0;
+
+    TEST_CHECK(spill_stack_size(&sstk, &size) == NO_ERROR && size == ELEMENTS_COUNT);
+    TEST_CHECK(sstk.spilled_count > 0);
+    TEST_CHECK(verify_spill_stack(&sstk) == NO_ERROR);
+
+    ssize_t hot_size = sstk.hot->size;
+
+    sstk.hot->size = -1;
+
+    TEST_CHECK(verify_spill_stack(&sstk) & SIZE_LESS_THAN_ZERO);
+
+    sstk.hot->size       = hot_size;
+    sstk.hot->error_code = NO_ERROR;
+
+    TYPE_ELEMENT_STACK original = 0;
+    TYPE_ELEMENT_STACK damaged  = -1;
+
+    TEST_CHECK(pread (sstk.descriptor, &original, sizeof(original), 0) == sizeof(original));
+    TEST_CHECK(pwrite(sstk.descriptor, &damaged,  sizeof(damaged),  0) == sizeof(damaged));
+    TEST_CHECK(verify_spill_stack(&sstk) == SPILL_SEGMENT_DAMAGED);
+    TEST_CHECK(pwrite(sstk.descriptor, &original, sizeof(original), 0) == sizeof(original));
+    TEST_CHECK(verify_spill_stack(&sstk) == NO_ERROR);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    for (int expected = ELEMENTS_COUNT - 1; expected >= 0; expected--)
+        TEST_CHECK(spill_pop(&sstk, &value) == NO_ERROR && value == expected);
+
+    TEST_CHECK(spill_pop(&sstk, &value) == SIZE_NULL_IN_POP);
+    TEST_CHECK(sstk.prefetch_hits + sstk.prefetch_misses > 0);
+    TEST_CHECK(spill_stack_destructor(&sstk) == NO_ERROR);
+
+    return TEST_RESULT();
+}
+
+// A path that already exists belongs to someone else: the constructor has to fail and leave it alone.
+void check_existing_path()
+{
+    char file_name[] = "/tmp/spill_stack_XXXXXX";
+
+    int descriptor = mkstemp(file_name);
+
+    TEST_CHECK(descriptor >= 0 && write(descriptor, "keep", 4) == 4);
+
+    spill_stack sstk = {};
+
+    TEST_CHECK(spill_stack_constructor(&sstk, file_name, MEMORY_BUDGET) == SPILL_SEGMENT_DAMAGED);
+
+    char contents[4] = {};
+
+    TEST_CHECK(access(file_name, F_OK) == 0);
+    TEST_CHECK(pread(descriptor, contents, sizeof(contents), 0) == 4 && contents[0] == 'k' && contents[3] == 'p');
+
+    close(descriptor);
+    unlink(file_name);
+}
@@ -0,0 +1,84 @@
+#include "stack.h"
+#include "test.h"
+
+#ifdef DEBUG_OUTPUT_STACK_DUMP_BINARY
+
+#include "stack_dump.h"
+#include <string.h>
+#include <unistd.h>
+
+int main()
+{
+    char file_name[] = "/tmp/stack_dump_XXXXXX";
+
+    Global_dump_descriptor = mkstemp(file_name);
+    TEST_CHECK(Global_dump_descriptor >= 0);
+
+    unlink(file_name);
+
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    for (int value = 1; value <= 5; value++)
+        TEST_CHECK(push(stk, value) == NO_ERROR);
+
+    ssize_t size = stk->size;
+
+    stk->size = stk->capacity + 1;
+
+    TEST_CHECK(push(stk, 6) & SIZE_MORE_THAN_CAPACITY);
+
+    stk->size       = size;
+    stk->error_code = NO_ERROR;
+
+    off_t length = lseek(Global_dump_descriptor, 0, SEEK_END);
+
+    TEST_CHECK(length >= (off_t) sizeof(stack_dump_header));
+
+    char *buffer = (char *) calloc((size_t) length + 1, 1);
+
+    TEST_CHECK(buffer != NULL && pread(Global_dump_descriptor, buffer, (size_t) length, 0) == length);
+
+    const stack_dump_header *header = (const stack_dump_header *) buffer;
+
+    TEST_CHECK(header->magic        == STACK_DUMP_MAGIC);
+    TEST_CHECK(header->version      == STACK_DUMP_VERSION);
+    TEST_CHECK(header->element_size == sizeof(TYPE_ELEMENT_STACK));
+    TEST_CHECK(header->record_length == (uint64_t) length);
+    TEST_CHECK(header->record_length % DUMP_ALIGNMENT == 0);
+    TEST_CHECK(header->size     == stk->capacity + 1);
+    TEST_CHECK(header->capacity == stk->capacity);
+    TEST_CHECK(header->error_code & SIZE_MORE_THAN_CAPACITY);
+    TEST_CHECK(header->flags & DUMP_HAS_BITMAP);
+
+    const char *strings = buffer + sizeof(stack_dump_header);
+
+    TEST_CHECK(strcmp(strings, "stk") == 0);
+
+    const TYPE_ELEMENT_STACK *data   = (const TYPE_ELEMENT_STACK *) (strings + header->strings_length);
+    const uint8_t            *bitmap = (const uint8_t *) (data + header->capacity);
+
+    for (ssize_t index = 0; index < size; index++)
+    {
+        TEST_CHECK(data[index] == index + 1);
+        TEST_CHECK(((bitmap[index / 8] >> (index % 8)) & 1) == 0);
+    }
+
+    free(buffer);
+    close(Global_dump_descriptor);
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    return TEST_RESULT();
+}
+
+#else
+
+int main()
+{
+    printf("skipped: built without DEBUG_OUTPUT_STACK_DUMP_BINARY\n");
+
+    return Test_failures;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "stack.h"
+#include "test.h"
+
+static void check_tail_is_sealed();
+
+int main()
+{
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    for (int value = 0; value < 100; value++)
+        TEST_CHECK(push(stk, value) == NO_ERROR);
+
+    ssize_t mark = -1;
+
+    TEST_CHECK(stack_mark(stk, &mark) == NO_ERROR && mark == 100);
+
+    for (int value = 100; value < 1000; value++)
+        TEST_CHECK(push(stk, value) == NO_ERROR);
+
+    ssize_t grown_capacity = stk->capacity;
+
+    TEST_CHECK(stack_rollback(stk, stk->size + 1) == INVALID_STACK_MARK);
+    TEST_CHECK(stack_rollback(stk, -1)            == INVALID_STACK_MARK);
+    TEST_CHECK(stk->size == 1000);
+
+    TEST_CHECK(stack_rollback(stk, mark) == NO_ERROR);
+    TEST_CHECK(stk->size == 100);
+    TEST_CHECK(stk->capacity < grown_capacity);
+    TEST_CHECK(stk->capacity >= stk->size);
+
+    TEST_CHECK(stack_rollback(stk, mark) == NO_ERROR && stk->size == 100);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 99);
+    TEST_CHECK(push(stk, 500)   == NO_ERROR);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 500);
+
+    TEST_CHECK(stack_rollback(stk, 0) == NO_ERROR && stk->size == 0);
+    TEST_CHECK(pop(stk, &value) == SIZE_NULL_IN_POP);
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    check_tail_is_sealed();
+
+    return TEST_RESULT();
+}
+
+// Rollback leaves poison above size, and a write there has to show up in the data hash.
+void check_tail_is_sealed()
+{
+    #if defined(HASH_PROTECT_INCLUDED) && !defined(SANITIZER_POISON_INCLUDED)
+        stack *stk = get_pointer_stack();
+        STACK_CONSTRUCTOR(stk);
+
+        for (int value = 0; value < 20; value++)
+            TEST_CHECK(push(stk, value) == NO_ERROR);
+
+        TEST_CHECK(stack_rollback(stk, 10) == NO_ERROR && stk->capacity > 12);
+
+        TYPE_ELEMENT_STACK poison = (stk->data)[12];
+
+        (stk->data)[12] = 12;
+
+        TEST_CHECK(verify_stack(stk) & DATA_HASH_CHANGED);
+
+        (stk->data)[12]  = poison;
+        stk->error_code = NO_ERROR;
+
+        TEST_CHECK(verify_stack(stk) == NO_ERROR);
+        TEST_CHECK(stack_reserve(stk, 2) == NO_ERROR);
+
+        (stk->data)[10] = 10;
+        (stk->data)[11] = 11;
+        (stk->data)[12] = 12;
+
+        TEST_CHECK(verify_stack(stk) & DATA_HASH_CHANGED);
+
+        (stk->data)[12]  = poison;
+        stk->error_code = NO_ERROR;
+
+        TEST_CHECK(stack_commit(stk, 12, 12) == NO_ERROR && stk->size == 12);
+        TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+    #endif
+}
@@ -0,0 +1,56 @@
+#include "stack.h"
+#include "test.h"
+
+#if defined(SANITIZER_POISON_INCLUDED) && defined(__SANITIZE_ADDRESS__)
+    #include <sanitizer/asan_interface.h>
+
+    #define IS_POISONED(address)    __asan_address_is_poisoned(address)
+#endif
+
+int main()
+{
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    // A stored value equal to POISON is still an element, whichever way free slots are marked.
+    for (int index = 0; index < 10; index++)
+        TEST_CHECK(push(stk, POISON) == NO_ERROR);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == POISON);
+
+    IF_ON_SANITIZER_POISON
+    (
+        #ifdef IS_POISONED
+            TEST_CHECK( IS_POISONED(stk->data + stk->size));
+            TEST_CHECK(!IS_POISONED(stk->data + stk->size - 1));
+        #endif
+    )
+
+    ELSE_IF_OFF_SANITIZER_POISON(TEST_CHECK(stk->data[stk->size] == POISON));
+
+    TEST_CHECK(stack_reserve(stk, 4) == NO_ERROR);
+
+    for (ssize_t index = stk->size; index < stk->size + 4; index++)
+        stk->data[index] = (TYPE_ELEMENT_STACK) index;
+
+    TEST_CHECK(stack_commit(stk, stk->size + 2, stk->size + 4) == NO_ERROR && stk->size == 11);
+
+    IF_ON_SANITIZER_POISON
+    (
+        #ifdef IS_POISONED
+            TEST_CHECK(IS_POISONED(stk->data + stk->size));
+        #endif
+    )
+
+    ELSE_IF_OFF_SANITIZER_POISON(TEST_CHECK(stk->data[stk->size] == POISON && stk->data[stk->size + 1] == POISON));
+
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 10);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 9);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == POISON);
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+
+    return TEST_RESULT();
+}
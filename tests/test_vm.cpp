@@ -0,0 +1,205 @@
+#include "vm.h"
+#include "test.h"
+#include <limits.h>
+#include <string.h>
+
+const char FIB_PROGRAM[] =
+    "        push 20         \n"
+    "        call fib        \n"
+    "        hlt             \n"
+    "fib:                    \n"
+    "        dup             \n"
+    "        push 2          \n"
+    "        lt              \n"
+    "        jnz fib_base    \n"
+    "        dup             \n"
+    "        push 1          \n"
+    "        sub             \n"
+    "        call fib        \n"
+    "        swap            \n"
+    "        push 2          \n"
+    "        sub             \n"
+    "        call fib        \n"
+    "        add             \n"
+    "        ret             \n"
+    "fib_base:               \n"
+    "        ret             \n";
+
+typedef ssize_t (*vm_runner)(vm_machine *vm, vm_program *program);
+
+static ssize_t run_switch(vm_machine *vm, vm_program *program);
+static ssize_t run_source(const char *source, vm_runner runner, TYPE_ELEMENT_STACK *result);
+static void    check_commit_verifies();
+static void    check_commit_open();
+
+int main()
+{
+    const vm_runner RUNNERS[] = {vm_run, run_switch};
+
+    for (size_t index = 0; index < sizeof(RUNNERS) / sizeof(RUNNERS[0]); index++)
+    {
+        TYPE_ELEMENT_STACK result = 0;
+
+        TEST_CHECK(run_source(FIB_PROGRAM, RUNNERS[index], &result) == VM_NO_ERROR && result == 6765);
+
+        TEST_CHECK(run_source("push -2147483648\npush -1\ndiv\nhlt\n", RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+        TEST_CHECK(run_source("push -2147483648\npush -1\nmod\nhlt\n", RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+        TEST_CHECK(run_source("push 7\npush 0\ndiv\nhlt\n",            RUNNERS[index], &result) == VM_DIVISION_BY_ZERO);
+
+        TEST_CHECK(run_source("push 2147483647\npush 1\nadd\nhlt\n",   RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+        TEST_CHECK(run_source("push -2147483648\npush 1\nsub\nhlt\n",  RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+        TEST_CHECK(run_source("push -2147483648\npush -1\nmul\nhlt\n", RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+        TEST_CHECK(run_source("push -2147483648\nneg\nhlt\n",          RUNNERS[index], &result) == VM_ARITHMETIC_OVERFLOW);
+
+        TEST_CHECK(run_source("push 2147483646\npush 1\nadd\nhlt\n",   RUNNERS[index], &result) == VM_NO_ERROR &&
+                   result == INT_MAX);
+        TEST_CHECK(run_source("push -2147483647\nneg\nhlt\n",          RUNNERS[index], &result) == VM_NO_ERROR &&
+                   result == INT_MAX);
+
+        TEST_CHECK(run_source("push -2147483648\npush 1\ndiv\nhlt\n", RUNNERS[index], &result) == VM_NO_ERROR &&
+                   result == INT_MIN);
+        TEST_CHECK(run_source("push -7\npush 2\nmod\nhlt\n",           RUNNERS[index], &result) == VM_NO_ERROR &&
+                   result == -1);
+    }
+
+    char source[8 * VM_MAX_LABEL_LENGTH] = {};
+    char label [2 * VM_MAX_LABEL_LENGTH] = {};
+
+    memset(label, 'l', VM_MAX_LABEL_LENGTH);
+
+    snprintf(source, sizeof(source), "jmp %s\n%s:\nhlt\n", label, label);
+
+    vm_program program    = {};
+    ssize_t    error_line = 0;
+
+    TEST_CHECK(vm_assemble(source, &program, &error_line) == VM_SYNTAX_ERROR && error_line == 1);
+
+    label[VM_MAX_LABEL_LENGTH - 2] = '\0';
+
+    snprintf(source, sizeof(source), "jmp %s\n%s:\nhlt\n", label, label);
+
+    TEST_CHECK(vm_assemble(source, &program, &error_line) == VM_NO_ERROR);
+    vm_program_destructor(&program);
+
+    check_commit_verifies();
+    check_commit_open();
+
+    return TEST_RESULT();
+}
+
+ssize_t run_switch(vm_machine *vm, vm_program *program)
+{
+    return vm_run_switch(vm, program);
+}
+
+ssize_t run_source(const char *source, vm_runner runner, TYPE_ELEMENT_STACK *result)
+{
+    vm_program program    = {};
+    ssize_t    error_line = 0;
+
+    ssize_t error_code = vm_assemble(source, &program, &error_line);
+
+    if (error_code != VM_NO_ERROR)
+        return error_code;
+
+    vm_machine vm = {};
+
+    vm_constructor(&vm, NULL);
+
+    error_code = runner(&vm, &program);
+
+    if (error_code == VM_NO_ERROR)
+        error_code = vm_pop_result(&vm, result);
+
+    // Every exit, error or not, leaves both stacks sealed.
+    TEST_CHECK(verify_stack(vm.operands) == NO_ERROR && verify_stack(vm.calls) == NO_ERROR);
+
+    vm_destructor(&vm);
+    vm_program_destructor(&program);
+
+    return error_code;
+}
+
+// stack_commit has to verify what was sealed before it takes the window, otherwise damage would be sealed as valid.
+void check_commit_verifies()
+{
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    for (int value = 0; value < 10; value++)
+        TEST_CHECK(push(stk, value) == NO_ERROR);
+
+    TEST_CHECK(stack_open(stk, 11, 0) == INVALID_STACK_MARK);
+    TEST_CHECK(stack_open(stk, 8, 4)  == NO_ERROR);
+
+    stk->data[8]  = 80;
+    stk->data[10] = 100;
+
+    #ifdef HASH_PROTECT_INCLUDED
+
+        stk->data[2] = -2;
+
+        TEST_CHECK(stack_commit(stk, 11, 11) == DATA_HASH_CHANGED);
+        TEST_CHECK(stk->size == 10);
+
+        stk->data[2]    = 2;
+        stk->error_code = NO_ERROR;
+
+    #endif
+
+    TEST_CHECK(stack_commit(stk, 11, 12) == NO_ERROR && stk->size == 11);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 100);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 9);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 80);
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+}
+
+// Sealing one window and opening the next is a single call, and it still refuses damage below the window.
+void check_commit_open()
+{
+    stack *stk = get_pointer_stack();
+    STACK_CONSTRUCTOR(stk);
+
+    for (int value = 0; value < 10; value++)
+        TEST_CHECK(push(stk, value) == NO_ERROR);
+
+    TEST_CHECK(stack_open(stk, 9, 1) == NO_ERROR);
+
+    stk->data[9]  = 90;
+    stk->data[10] = 100;
+
+    TEST_CHECK(stack_commit_open(stk, 11, 11, 12, 0) == INVALID_STACK_MARK);
+    TEST_CHECK(stack_commit_open(stk, 11, 11, 10, 3) == NO_ERROR && stk->size == 11 && stk->capacity >= 14);
+
+    stk->data[10] = 101;
+    stk->data[11] = 110;
+    stk->data[12] = 120;
+
+    #ifdef HASH_PROTECT_INCLUDED
+
+        stk->data[9] = -9;
+
+        TEST_CHECK(stack_commit_open(stk, 13, 13, 13, 0) == DATA_HASH_CHANGED);
+        TEST_CHECK(stk->size == 11);
+
+        stk->data[9]    = 90;
+        stk->error_code = NO_ERROR;
+
+    #endif
+
+    TEST_CHECK(stack_commit(stk, 13, 13) == NO_ERROR && stk->size == 13);
+
+    TYPE_ELEMENT_STACK value = 0;
+
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 120);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 110);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 101);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 90);
+    TEST_CHECK(pop(stk, &value) == NO_ERROR && value == 8);
+
+    TEST_CHECK(stack_destructor(stk) == NO_ERROR);
+}